@@ -0,0 +1,121 @@
+// Measures the cost of laying out a tree of 10k elements: every iteration invalidates the
+// layout and then asks every leaf for its rectangle, which evaluates the alignments of the
+// leaves and of the containers above them. A second measurement evaluates the same kind of
+// alignment as nested std::function closures, the way alignments used to be stored.
+#include "firecrest.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+using namespace fc;
+using namespace fc::alignment;
+
+namespace {
+
+// The root of the tree, with a fixed size instead of the size of a window
+class Root : public Container {
+public:
+    Root() : Container(ElementAlignment()) {}
+
+    glm::vec2 getPixelPosition() const override { return {0.0f, 0.0f}; }
+    glm::vec2 getPixelSize() const override { return {1920.0f, 1080.0f}; }
+};
+
+// The width used by every leaf, a mix of the common combinators
+AlignmentFunction leafWidth() {
+    return Max(Relative(0.5f) - Pixels(8.0f), SwapRef(Relative(0.25f)));
+}
+
+using StdAlignmentFunction = std::function<float(float, float)>;
+
+StdAlignmentFunction stdPixels(float pixels) {
+    return [pixels](float, float) { return pixels; };
+}
+StdAlignmentFunction stdRelative(float coefficient) {
+    return [coefficient](float parent1, float) { return parent1 * coefficient; };
+}
+StdAlignmentFunction stdSubtract(StdAlignmentFunction a, StdAlignmentFunction b) {
+    return [a, b](float parent1, float parent2) {
+        return a(parent1, parent2) - b(parent1, parent2);
+    };
+}
+StdAlignmentFunction stdSwapRef(StdAlignmentFunction function) {
+    return [function](float parent1, float parent2) { return function(parent2, parent1); };
+}
+StdAlignmentFunction stdMax(StdAlignmentFunction a, StdAlignmentFunction b) {
+    return [a, b](float parent1, float parent2) {
+        return std::max(a(parent1, parent2), b(parent1, parent2));
+    };
+}
+
+template <typename F> double measure(uint32_t iterations, F&& function) {
+    // Warm up
+    for (uint32_t i = 0; i < iterations / 8 + 1; i++) {
+        function();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+} // namespace
+
+int main() {
+    constexpr size_t COLUMNS = 100;
+    constexpr size_t ROWS = 100;
+    constexpr uint32_t ITERATIONS = 256;
+
+    Root root;
+    std::vector<Element*> leaves;
+    leaves.reserve(COLUMNS * ROWS);
+
+    for (size_t column = 0; column < COLUMNS; column++) {
+        auto& list = root.createChild<VerticalPositioning>(
+            ElementAlignment(Relative(static_cast<float>(column) / COLUMNS), Pixels(0),
+                             Relative(1.0f / COLUMNS), Relative(1)));
+        list.setSpacing(2.0f);
+
+        for (size_t row = 0; row < ROWS; row++) {
+            leaves.push_back(&list.createChild<Element>(
+                ElementAlignment(Pixels(4), Pixels(0), leafWidth(), Pixels(10))));
+        }
+    }
+
+    float checksum = 0.0f;
+    const double layoutTime = measure(ITERATIONS, [&]() {
+        Element::invalidateLayout();
+        for (const Element* leaf : leaves) {
+            const Rectangle rectangle = leaf->getPixelRectangle();
+            checksum += rectangle.y + rectangle.width;
+        }
+    });
+
+    // The same width alignment, evaluated once per leaf
+    const AlignmentFunction expression = leafWidth();
+    const StdAlignmentFunction closures
+        = stdMax(stdSubtract(stdRelative(0.5f), stdPixels(8.0f)), stdSwapRef(stdRelative(0.25f)));
+
+    const double expressionTime = measure(ITERATIONS, [&]() {
+        for (size_t i = 0; i < leaves.size(); i++) {
+            checksum += expression(static_cast<float>(i), 1080.0f);
+        }
+    });
+    const double closureTime = measure(ITERATIONS, [&]() {
+        for (size_t i = 0; i < leaves.size(); i++) {
+            checksum += closures(static_cast<float>(i), 1080.0f);
+        }
+    });
+
+    std::printf("%zu elements\n", leaves.size() + COLUMNS);
+    std::printf("%-32s %12.2f us\n", "layout", layoutTime);
+    std::printf("%-32s %12.2f us\n", "width, AlignmentFunction", expressionTime);
+    std::printf("%-32s %12.2f us\n", "width, nested std::function", closureTime);
+    // Keeps the evaluations from being optimized away
+    std::printf("(checksum %f)\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Measures how fast .obj files are parsed, in MB/s, with the memory-mapped parser used by
+// res::loadModel and with the line by line parser it replaced. A grid of quads with positions,
+// texture coordinates and normals is written to a temporary file first. Only the parsing is
+// measured: no meshes are created, so no window is needed.
+#include "firecrest.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace fc;
+
+namespace {
+
+void writeGrid(const std::string& path, int size) {
+    std::ofstream file(path);
+    file << "# " << size << "x" << size << " grid\n";
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            file << "v " << x * 0.01f << " " << y * 0.01f << " " << (x * y % 7) * 0.001f << "\n";
+            file << "vt " << static_cast<float>(x) / size << " " << static_cast<float>(y) / size
+                 << "\n";
+            file << "vn 0.0 0.0 1.0\n";
+        }
+    }
+    file << "usemtl grid\n";
+    for (int y = 0; y + 1 < size; y++) {
+        for (int x = 0; x + 1 < size; x++) {
+            const int a = y * size + x + 1;
+            const int b = a + 1;
+            const int c = a + size + 1;
+            const int d = a + size;
+            file << "f " << a << "/" << a << "/" << a << " " << b << "/" << b << "/" << b << " "
+                 << c << "/" << c << "/" << c << " " << d << "/" << d << "/" << d << "\n";
+        }
+    }
+}
+
+// The parsing loop res::loadModel used before, without the meshes and materials
+size_t parseLineByLine(const std::string& path) {
+    using namespace fc::utils;
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<gl::Vertex3D> vertices;
+
+    std::ifstream file(path);
+    std::string line;
+    while (getline(file, line)) {
+        line = whitespaceToSpace(line);
+        size_t commentStart = line.find("#");
+        if (commentStart != std::string::npos) {
+            line = line.substr(0, commentStart);
+        }
+        utils::trim(line);
+        std::vector<std::string> tokens = strsplit(line, " ");
+        if (tokens.size() == 0 || line.empty())
+            continue;
+
+        if (tokens[0] == "v") {
+            positions.push_back({std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3])});
+        } else if (tokens[0] == "vn") {
+            normals.push_back({std::stof(tokens[1]), std::stof(tokens[2]), std::stof(tokens[3])});
+        } else if (tokens[0] == "vt") {
+            texCoords.push_back({std::stof(tokens[1]), std::stof(tokens[2])});
+        } else if (tokens[0] == "f") {
+            std::vector<gl::Vertex3D> points;
+            for (uint32_t i = 1; i < tokens.size(); i++) {
+                std::vector<std::string> vertexData = strsplit(tokens[i], "/");
+                gl::Vertex3D vertex;
+                vertex.position = positions[std::stoi(vertexData[0]) - 1];
+                vertex.texCoord = texCoords[std::stoi(vertexData[1]) - 1];
+                vertex.normal = normals[std::stoi(vertexData[2]) - 1];
+                points.push_back(vertex);
+            }
+            for (uint32_t i = 1; i < points.size() - 1; i++) {
+                vertices.push_back(points[0]);
+                vertices.push_back(points[i]);
+                vertices.push_back(points[i + 1]);
+            }
+        }
+    }
+    return vertices.size();
+}
+
+size_t parseMapped(const std::string& path) {
+    const MappedFile file(path);
+    const res::ObjData data = res::parseObj(file.view());
+
+    // The faces are indexed, so the old parser's vertices are the indices here
+    size_t indices = 0;
+    for (const res::ObjGroup& group : data.groups) {
+        indices += group.indices.size();
+    }
+    return indices;
+}
+
+template <typename F> double measureSeconds(uint32_t iterations, F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() / iterations;
+}
+} // namespace
+
+int main() {
+    constexpr uint32_t ITERATIONS = 4;
+    const std::string path
+        = (std::filesystem::temp_directory_path() / "firecrest_obj_parse.obj").string();
+
+    std::printf("%zu worker threads\n", parallel::workerCount());
+    std::printf("%10s %10s %12s %16s %16s\n", "grid", "MB", "triangles", "getline (MB/s)",
+                "mapped (MB/s)");
+
+    for (int size = 128; size <= 1024; size *= 2) {
+        writeGrid(path, size);
+        const double megabytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+        size_t lineByLineVertices = 0;
+        size_t mappedVertices = 0;
+        const double lineByLineTime
+            = measureSeconds(ITERATIONS, [&]() { lineByLineVertices = parseLineByLine(path); });
+        const double mappedTime
+            = measureSeconds(ITERATIONS, [&]() { mappedVertices = parseMapped(path); });
+
+        if (lineByLineVertices != mappedVertices) {
+            std::printf("The parsers disagree: %zu and %zu vertices\n", lineByLineVertices,
+                        mappedVertices);
+            return 1;
+        }
+
+        std::printf("%5dx%-4d %10.1f %12zu %16.1f %16.1f\n", size, size, megabytes,
+                    mappedVertices / 3, megabytes / lineByLineTime, megabytes / mappedTime);
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
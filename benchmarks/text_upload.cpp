@@ -0,0 +1,64 @@
+// Measures the cost of recording and uploading a single string with the TextRenderer, for
+// strings of increasing length. Each frame records the string, flushes the batch and waits for
+// the GPU, so the time includes the upload and the draw.
+#include "firecrest.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace fc;
+
+int main() {
+    WindowProperties properties;
+    properties.width = 1280;
+    properties.height = 720;
+    properties.vsync = false;
+    properties.title = "Text upload benchmark";
+
+    Window window(properties);
+    TextRenderer textRenderer(RESOURCES_PATH "JetBrainsMono-Regular.ttf");
+
+    const glm::vec2 viewportSize = static_cast<glm::vec2>(window.dimensions());
+    const Rectangle clip(0, 0, viewportSize.x, viewportSize.y);
+    constexpr uint32_t WARMUP_FRAMES = 16;
+    constexpr uint32_t FRAMES = 256;
+
+    std::printf("%10s %14s %14s %14s\n", "chars", "record (us)", "flush (us)", "ns / char");
+
+    for (size_t length = 16; length <= 65536; length *= 4) {
+        std::string text;
+        text.reserve(length);
+        for (size_t i = 0; i < length; i++) {
+            text.push_back(static_cast<char>('!' + i % 94));
+        }
+
+        double recordTime = 0.0;
+        double flushTime = 0.0;
+
+        for (uint32_t frame = 0; frame < WARMUP_FRAMES + FRAMES; frame++) {
+            window.clearScreen();
+
+            auto start = std::chrono::steady_clock::now();
+            textRenderer.renderText(viewportSize, text, glm::vec3(0, 360, 0), 8.0f,
+                                    glm::vec4(1, 1, 1, 1), clip);
+            auto recorded = std::chrono::steady_clock::now();
+            textRenderer.flush();
+            glFinish();
+            auto flushed = std::chrono::steady_clock::now();
+
+            if (frame >= WARMUP_FRAMES) {
+                recordTime += std::chrono::duration<double, std::micro>(recorded - start).count();
+                flushTime += std::chrono::duration<double, std::micro>(flushed - recorded).count();
+            }
+
+            window.display();
+        }
+
+        recordTime /= FRAMES;
+        flushTime /= FRAMES;
+        std::printf("%10zu %14.2f %14.2f %14.2f\n", length, recordTime, flushTime,
+                    (recordTime + flushTime) * 1000.0 / length);
+    }
+
+    return 0;
+}
@@ -39,6 +39,10 @@ int main() {
         = v2.createChild<Graph>(alignment::ElementAlignment(), shapeRenderer, textRenderer, 16.0f);
     std::vector<glm::vec2> graphData;
     float graphTimeOffset = 0.0f;
+    // The graph gets a point per step until it is full, after which the demo idles until input
+    const time::Duration GRAPH_STEP = time::Duration::fromMillis(50);
+    const size_t GRAPH_POINTS = 200;
+    time::Moment nextGraphPoint = time::now();
 
     v3.createChild<ColoredRect>(alignment::ElementAlignment(), glm::vec4(0, 0, 0, 1),
                                 shapeRenderer);
@@ -107,9 +111,24 @@ void main()
         time::Duration delta = now - lastTime;
         lastTime = now;
 
-        graphData.push_back({graphTimeOffset, sin(graphTimeOffset) * graphTimeOffset});
-        graph.setData(graphData);
-        graphTimeOffset += 0.15f;
+        // Upload what the background loads have finished, a few milliseconds per frame. The
+        // placeholders are filled in place, so the display has to be rendered again.
+        if (res.processUploads(time::Duration::fromMillis(4)) > 0) {
+            display.markDirty();
+        }
+
+        if (graphData.size() < GRAPH_POINTS && now >= nextGraphPoint) {
+            graphData.push_back({graphTimeOffset, sin(graphTimeOffset) * graphTimeOffset});
+            graph.setData(graphData);
+            graphTimeOffset += 0.15f;
+            nextGraphPoint = now + GRAPH_STEP;
+        }
+
+        // Only render when something changed, otherwise wait for input
+        if (!display.needsRender()) {
+            window.waitEvents(1.0 / 60.0);
+            continue;
+        }
 
         window.clearScreen();
         display.render();
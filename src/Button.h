@@ -41,9 +41,11 @@ public:
         switch (event.action) {
         case input::MouseMotionAction::Enter:
             background.color = hoverColor;
+            markDirty();
             break;
         case input::MouseMotionAction::Exit:
             background.color = color;
+            markDirty();
             break;
         };
     }
@@ -59,6 +61,7 @@ public:
                 background.color = hoverColor;
                 break;
             }
+            markDirty();
         }
     }
 
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Container.h"
+#include "gl/IndexBuffer.h"
+#include "gl/RenderRegion.h"
+#include "gl/RenderTarget.h"
+#include "gl/Shader.h"
+#include "gl/State.h"
+#include "gl/VertexArray.h"
+#include "gl/VertexBuffer.h"
+#include "gl/VertexBufferLayout.h"
+#include <memory>
+
+namespace fc {
+
+// A container that renders its children into a texture once, and then draws only that texture
+// for as long as none of the children is marked dirty and the layer keeps its place and size.
+// A static panel of many elements then costs a single quad per frame.
+//
+// The layer starts out transparent and is drawn with premultiplied alpha. The 2D renderers
+// blend alpha with (GL_ONE, GL_ONE_MINUS_SRC_ALPHA), so the layer holds the coverage of its
+// children and translucent children look the same as without the layer. Text recorded before
+// the layer is drawn beneath it, whether or not the children were rendered again.
+class CachedLayer : public Container {
+private:
+    std::unique_ptr<gl::RenderTarget> _target;
+    gl::Shader _shader;
+    gl::Uniform _projectionUniform;
+    gl::Uniform _regionUniform;
+    gl::Uniform _layerUniform;
+    gl::VertexArray _vao;
+    gl::VertexBuffer _vbo;
+    gl::IndexBuffer _ibo;
+
+    // The change generation and the window region of the last time the children were rendered
+    uint64_t _renderedGeneration = 0;
+    Rectangle _renderedRegion{0, 0, 0, 0};
+
+public:
+    CachedLayer(alignment::ElementAlignment alignment) : Container(alignment) {
+        const char* VERTEX_SOURCE = R"(
+            #version 330 core
+            layout(location = 0) in vec2 aPos;
+
+            uniform mat4 projection;
+            uniform vec4 region; // x, y, width, height
+
+            out vec2 uv;
+
+            void main() {
+                uv = aPos;
+                gl_Position = projection * vec4(region.xy + aPos * region.zw, 0.0, 1.0);
+            }
+        )";
+
+        const char* FRAGMENT_SOURCE = R"(
+            #version 330 core
+            in vec2 uv;
+            out vec4 FragColor;
+
+            uniform sampler2D layer;
+
+            void main() {
+                FragColor = texture(layer, uv);
+            }
+        )";
+
+        _shader.addStageSource(GL_VERTEX_SHADER, VERTEX_SOURCE);
+        _shader.addStageSource(GL_FRAGMENT_SHADER, FRAGMENT_SOURCE);
+        _shader.link();
+        _projectionUniform = _shader.uniform("projection");
+        _regionUniform = _shader.uniform("region");
+        _layerUniform = _shader.uniform("layer");
+
+        _vao.bind();
+
+        gl::VertexBufferLayout layout;
+        layout.push(GL_FLOAT, 2); // aPos
+
+        _vao.addBuffer(_vbo, layout);
+        _vao.addBuffer(_ibo);
+
+        _vao.unbind();
+        _vbo.unbind();
+        _ibo.unbind();
+
+        const float vertices[] = {
+            0.0f, 0.0f, // bottom left
+            1.0f, 0.0f, // bottom right
+            1.0f, 1.0f, // top right
+            0.0f, 1.0f  // top left
+        };
+        GLuint indices[] = {0, 1, 2, 2, 3, 0};
+
+        _vbo.setData(vertices, sizeof(vertices), GL_STATIC_DRAW);
+        _ibo.setIndices(indices, sizeof(indices) / sizeof(GLuint));
+    }
+
+    virtual void render(const Window& window, time::Duration delta) override {
+        const Rectangle region = layerRegion();
+        if (region.width <= 0 || region.height <= 0)
+            return;
+
+        if (changeGeneration() > _renderedGeneration || region.position != _renderedRegion.position
+            || region.size != _renderedRegion.size) {
+            renderChildren(window, delta, region);
+        }
+
+        drawLayer(window, region);
+    }
+
+private:
+    // The whole pixels the layer covers, so that the texture maps one to one onto the window
+    Rectangle layerRegion() const {
+        const Rectangle rect = getPixelRectangle();
+        const glm::vec2 min = glm::floor(rect.position);
+        const glm::vec2 max = glm::ceil(rect.position + rect.size);
+        return {min, max - min};
+    }
+
+    void renderChildren(const Window& window, time::Duration delta, const Rectangle& region) {
+        const int width = static_cast<int>(region.width);
+        const int height = static_cast<int>(region.height);
+        if (!_target) {
+            _target = std::make_unique<gl::RenderTarget>(width, height);
+        } else {
+            _target->resize(width, height);
+        }
+
+        // Children marked dirty while rendering are rendered again in the next frame
+        _renderedGeneration = currentChangeGeneration();
+        _renderedRegion = region;
+
+        gl::RenderRegion::pushTarget(*_target, region);
+        _target->clear(0.0f, 0.0f, 0.0f, 0.0f);
+        Container::render(window, delta);
+        gl::RenderRegion::popTarget();
+    }
+
+    void drawLayer(const Window& window, const Rectangle& region) {
+        // What lies beneath the layer is drawn first. Text is only flushed on its own when the
+        // children were rendered into the target, so it is flushed here too.
+        gl::RenderRegion::flushBatches();
+        gl::RenderRegion::push(region, gl::RenderRegion::Mode::Scissor);
+
+        // The children were blended onto a transparent layer, which premultiplies the colors
+        gl::State::enable(GL_BLEND);
+        gl::State::blendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        gl::State::enable(GL_CULL_FACE);
+        gl::State::cullFace(GL_BACK);
+
+        gl::State::disable(GL_DEPTH_TEST);
+
+        _shader.bind();
+        _projectionUniform.set(window.orthographicProjection());
+        _regionUniform.set(glm::vec4(region.position, region.size));
+        _layerUniform.set(0);
+        _target->bindTexture(0);
+
+        _vao.bind();
+        _ibo.bind();
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(_ibo.getCount()), GL_UNSIGNED_INT,
+                       nullptr);
+        _vao.unbind();
+        _ibo.unbind();
+
+        gl::RenderRegion::pop();
+    }
+};
+} // namespace fc
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ColoredBatchRenderer.h"
+#include "gl/State.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "res/ResourceManager.h"
 
@@ -34,9 +35,40 @@ void main() {
 }
 )";
 
+static constexpr const char* INSTANCED_VERTEX_SOURCE = R"(
+#version 450 core
+layout (location = 0) in vec2 a_Position;
+layout (location = 1) in vec2 a_Scale;
+layout (location = 2) in uint a_RGBA;
+
+uniform mat4 u_ViewProj;
+uniform mat4 u_Transform;
+
+out vec4 v_Color;
+
+// The quad is drawn as a triangle strip
+const vec2 corners[4] = {
+	vec2(-0.5, -0.5),
+	vec2( 0.5, -0.5),
+	vec2(-0.5,  0.5),
+	vec2( 0.5,  0.5),
+};
+
+void main() {
+	uint r =  a_RGBA        & 255;
+	uint g = (a_RGBA >> 8)  & 255;
+	uint b = (a_RGBA >> 16) & 255;
+	uint a = (a_RGBA >> 24) & 255;
+	v_Color = vec4(float(r) / 255.0, float(g) / 255.0, float(b) / 255.0, float(a) / 255.0);
+	vec2 position = corners[gl_VertexID] * a_Scale + a_Position;
+	gl_Position = u_ViewProj * u_Transform * vec4(position, 0.0, 1.0);
+}
+)";
+
 namespace fc {
 void ColoredBatchRenderer::createIndicesForQuads(size_t quadCount) {
-    if (quadCount * INDICES_PER_QUAD == indices.size())
+    // The index pattern is the same for every quad, so the buffer only has to grow
+    if (quadCount * INDICES_PER_QUAD <= indices.size())
         return;
     indices.resize(quadCount * INDICES_PER_QUAD);
 
@@ -59,9 +91,7 @@ void ColoredBatchRenderer::createIndicesForQuads(size_t quadCount) {
 std::array<ColoredBatchRenderer::Vertex, 4>
 ColoredBatchRenderer::createQuad(const glm::vec2 position, const glm::vec2 scale,
                                  const glm::vec4 color) {
-    GLuint packedColor
-        = ((GLuint)(GLubyte)(color.r * 255) << 0) | ((GLuint)(GLubyte)(color.g * 255) << 8)
-          | ((GLuint)(GLubyte)(color.b * 255) << 16) | ((GLuint)(GLubyte)(color.a * 255) << 24);
+    GLuint packedColor = packColor(color);
 
     ColoredBatchRenderer::Vertex v1;
     v1.position = glm::vec2(-0.5f, -0.5f) * scale + position;
@@ -82,11 +112,42 @@ ColoredBatchRenderer::createQuad(const glm::vec2 position, const glm::vec2 scale
     return {v1, v2, v3, v4};
 }
 
-ColoredBatchRenderer::ColoredBatchRenderer(Window& window, res::ResourceManager& resourceManager)
-    : window(window), resourceManager(resourceManager) {
-    shader = resourceManager.loadShaderSource(VERTEX_SOURCE, FRAGMENT_SOURCE);
+GLuint ColoredBatchRenderer::packColor(const glm::vec4 color) {
+    return ((GLuint)(GLubyte)(color.r * 255) << 0) | ((GLuint)(GLubyte)(color.g * 255) << 8)
+           | ((GLuint)(GLubyte)(color.b * 255) << 16) | ((GLuint)(GLubyte)(color.a * 255) << 24);
+}
+
+ColoredBatchRenderer::ColoredBatchRenderer(Window& window, res::ResourceManager& resourceManager,
+                                           Mode mode)
+    : mode(mode), window(window), resourceManager(resourceManager) {
+    if (mode == Mode::Instanced) {
+        shader = resourceManager.loadShaderSource(INSTANCED_VERTEX_SOURCE, FRAGMENT_SOURCE);
+        vbo.reserve(1024 * sizeof(ColoredBatchRenderer::Instance),
+                    sizeof(ColoredBatchRenderer::Instance));
+    } else {
+        shader = resourceManager.loadShaderSource(VERTEX_SOURCE, FRAGMENT_SOURCE);
+        vbo.reserve(1024 * sizeof(ColoredBatchRenderer::Vertex) * VERTICES_PER_QUAD,
+                    sizeof(ColoredBatchRenderer::Vertex));
+    }
     shader->bind();
 
+    setupVertexArray();
+}
+
+void ColoredBatchRenderer::setupVertexArray() {
+    if (mode == Mode::Instanced) {
+        gl::VertexBufferLayout layout;
+        layout.push(GL_FLOAT, 2);        // Position
+        layout.push(GL_FLOAT, 2);        // Scale
+        layout.push(GL_UNSIGNED_INT, 1); // Color
+
+        vao.addInstanceBuffer(vbo, layout);
+
+        vao.unbind();
+        vbo.unbind();
+        return;
+    }
+
     vao.bind();
     vbo.bind();
 
@@ -105,17 +166,19 @@ ColoredBatchRenderer::ColoredBatchRenderer(Window& window, res::ResourceManager&
 
 void ColoredBatchRenderer::clearElements() {
     vertices.clear();
+    instances.clear();
 }
 
 void ColoredBatchRenderer::draw() {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (vertices.empty() && instances.empty())
+        return;
 
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+    gl::State::enable(GL_BLEND);
+    gl::State::blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                                 GL_ONE_MINUS_SRC_ALPHA);
 
-    vbo.setData(vertices.data(), vertices.size() * sizeof(ColoredBatchRenderer::Vertex),
-                GL_STREAM_DRAW);
+    gl::State::enable(GL_CULL_FACE);
+    gl::State::cullFace(GL_BACK);
 
     shader->bind();
 
@@ -127,21 +190,72 @@ void ColoredBatchRenderer::draw() {
 
     shader->setUniformMat4f("u_ViewProj", projection);
     shader->setUniformMat4f("u_Transform", view);
+
+    if (mode == Mode::Instanced) {
+        drawInstances();
+    } else {
+        drawVertices();
+    }
+}
+
+void ColoredBatchRenderer::drawVertices() {
+    const size_t quadCount = vertices.size() / VERTICES_PER_QUAD;
+    createIndicesForQuads(quadCount);
+
+    const GLsizeiptr vertexBytes = vertices.size() * sizeof(ColoredBatchRenderer::Vertex);
+    if (vbo.reserve(vertexBytes, sizeof(ColoredBatchRenderer::Vertex))) {
+        setupVertexArray();
+    }
+    const GLintptr vertexOffset
+        = vbo.write(vertices.data(), vertexBytes, sizeof(ColoredBatchRenderer::Vertex));
+
     vao.bind();
     ibo.bind();
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    glDrawElementsBaseVertex(
+        GL_TRIANGLES, static_cast<GLsizei>(quadCount * INDICES_PER_QUAD), GL_UNSIGNED_INT, nullptr,
+        static_cast<GLint>(vertexOffset / sizeof(ColoredBatchRenderer::Vertex)));
+}
+
+void ColoredBatchRenderer::drawInstances() {
+    const GLsizeiptr instanceBytes = instances.size() * sizeof(ColoredBatchRenderer::Instance);
+    if (vbo.reserve(instanceBytes, sizeof(ColoredBatchRenderer::Instance))) {
+        setupVertexArray();
+    }
+    const GLintptr instanceOffset
+        = vbo.write(instances.data(), instanceBytes, sizeof(ColoredBatchRenderer::Instance));
+
+    vao.bind();
+    glDrawArraysInstancedBaseInstance(
+        GL_TRIANGLE_STRIP, 0, VERTICES_PER_QUAD, static_cast<GLsizei>(instances.size()),
+        static_cast<GLuint>(instanceOffset / sizeof(ColoredBatchRenderer::Instance)));
 }
 
 void ColoredBatchRenderer::reserve(const size_t quadCount) {
+    if (mode == Mode::Instanced) {
+        instances.reserve(quadCount);
+        if (vbo.reserve(quadCount * sizeof(ColoredBatchRenderer::Instance),
+                        sizeof(ColoredBatchRenderer::Instance))) {
+            setupVertexArray();
+        }
+        return;
+    }
+
     vertices.reserve(quadCount * VERTICES_PER_QUAD);
     createIndicesForQuads(quadCount);
 
-    vbo.setData(nullptr, quadCount * sizeof(ColoredBatchRenderer::Vertex) * VERTICES_PER_QUAD,
-                GL_STREAM_DRAW);
+    if (vbo.reserve(quadCount * sizeof(ColoredBatchRenderer::Vertex) * VERTICES_PER_QUAD,
+                    sizeof(ColoredBatchRenderer::Vertex))) {
+        setupVertexArray();
+    }
 }
 
 void ColoredBatchRenderer::addQuad(const glm::vec2 position, const glm::vec2 scale,
                                    const glm::vec4 color) {
+    if (mode == Mode::Instanced) {
+        instances.push_back({position, scale, packColor(color)});
+        return;
+    }
+
     std::array<ColoredBatchRenderer::Vertex, 4> quad = createQuad(position, scale, color);
     vertices.push_back(quad[0]);
     vertices.push_back(quad[1]);
@@ -3,6 +3,7 @@
 #include "Window.h"
 #include "fiv.hpp"
 #include "gl/IndexBuffer.h"
+#include "gl/StreamBuffer.h"
 #include "gl/VertexArray.h"
 #include "gl/VertexBufferLayout.h"
 #include "glm/glm.hpp"
@@ -13,6 +14,14 @@
 namespace fc {
 
 class ColoredBatchRenderer {
+public:
+    enum class Mode : uint8_t {
+        // Every quad is expanded into 4 vertices and 6 indices on the CPU
+        Vertices,
+        // Every quad is a single instance, expanded into a unit quad by the vertex shader
+        Instanced
+    };
+
 private:
     struct Vertex {
         glm::vec2 position;
@@ -20,16 +29,25 @@ private:
                      // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
     };
 
+    struct Instance {
+        glm::vec2 position;
+        glm::vec2 scale;
+        GLuint RGBA;
+    };
+
 private:
     const uint32_t INDICES_PER_QUAD = 6;
     const uint32_t VERTICES_PER_QUAD = 4;
 
 private:
+    Mode mode;
+
     std::vector<ColoredBatchRenderer::Vertex> vertices;
+    std::vector<ColoredBatchRenderer::Instance> instances;
 
     std::vector<GLuint> indices;
     gl::IndexBuffer ibo;
-    gl::VertexBuffer vbo;
+    gl::StreamVertexBuffer vbo;
     gl::VertexArray vao;
     res::ShaderHandle shader;
 
@@ -38,11 +56,17 @@ private:
 
 private:
     void createIndicesForQuads(size_t quadCount);
+    void setupVertexArray();
     std::array<ColoredBatchRenderer::Vertex, 4>
     createQuad(const glm::vec2 position, const glm::vec2 scale, const glm::vec4 color);
+    static GLuint packColor(const glm::vec4 color);
+
+    void drawVertices();
+    void drawInstances();
 
 public:
-    ColoredBatchRenderer(Window& window, res::ResourceManager& resourceManager);
+    ColoredBatchRenderer(Window& window, res::ResourceManager& resourceManager,
+                         Mode mode = Mode::Vertices);
     void clearElements();
     void reserve(const size_t quadCount);
     void addQuad(const glm::vec2 position, const glm::vec2 scale, const glm::vec4 color);
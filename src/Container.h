@@ -15,6 +15,11 @@ protected:
     // This function is called immediately after a child is created.
     virtual void childCreated(fiv::ID id) {}
 
+    // The range [first, last) of child indices that may be visible. Only these children are
+    // rendered and receive mouse events. Containers that know most of their children are out
+    // of view can narrow it down.
+    virtual std::pair<size_t, size_t> visibleChildRange() const { return {0, _children.size()}; }
+
 public:
     Container(alignment::ElementAlignment alignment) : Element(alignment), _children(true) {}
 
@@ -23,6 +28,8 @@ public:
         fiv::ID id = _children.emplace(std::make_unique<T>(std::forward<Args>(args)...));
         _children[id]->_parent = this;
         childCreated(id);
+        invalidateLayout();
+        markDirty();
         return static_cast<T&>(*_children[id]);
     }
 
@@ -31,19 +38,24 @@ public:
         fiv::ID id = _children.emplace(std::make_unique<T>(std::forward<Args>(args)...));
         _children[id]->_parent = this;
         childCreated(id);
+        invalidateLayout();
+        markDirty();
         return {static_cast<T&>(*_children[id]), id};
     }
 
     const fiv::Vector<std::unique_ptr<Element>>& children() const { return _children; }
 
     virtual void render(const Window& window, time::Duration delta) override {
-        for (const auto& child : children()) {
-            child->render(window, delta);
+        const auto [first, last] = visibleChildRange();
+        for (size_t i = first; i < last; i++) {
+            _children.dataAt(i)->render(window, delta);
         }
     }
 
     virtual void onMouseMotionEvent(Input& input, input::MouseMotionEvent event) override {
-        for (auto& child : children()) {
+        const auto [first, last] = visibleChildRange();
+        for (size_t i = first; i < last; i++) {
+            const auto& child = _children.dataAt(i);
             const Rectangle childRect = child->getPixelRectangle();
 
             const bool wasInside = childRect.contains(event.lastPosition);
@@ -63,7 +75,9 @@ public:
 
     virtual void onMouseButtonEvent(Input& input, input::MouseButtonEvent event) override {
         const glm::vec2 mousePos = input.mouse();
-        for (auto& child : children()) {
+        const auto [first, last] = visibleChildRange();
+        for (size_t i = first; i < last; i++) {
+            const auto& child = _children.dataAt(i);
             const Rectangle childRect = child->getPixelRectangle();
 
             if (!childRect.contains(mousePos))
@@ -75,7 +89,9 @@ public:
 
     virtual void onScroll(Input& input, input::ScrollEvent event) override {
         const glm::vec2 mousePos = input.mouse();
-        for (auto& child : children()) {
+        const auto [first, last] = visibleChildRange();
+        for (size_t i = first; i < last; i++) {
+            const auto& child = _children.dataAt(i);
             const Rectangle childRect = child->getPixelRectangle();
 
             if (!childRect.contains(mousePos))
@@ -86,7 +102,9 @@ public:
     }
 
     virtual Element* findFocusedElement(glm::vec2 mousePosition) override {
-        for (auto& child : _children) {
+        const auto [first, last] = visibleChildRange();
+        for (size_t i = first; i < last; i++) {
+            const auto& child = _children.dataAt(i);
             Rectangle childRect = child->getPixelRectangle();
             if (childRect.contains(mousePosition)) {
                 Element* focusedChild = child->findFocusedElement(mousePosition);
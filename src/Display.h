@@ -4,6 +4,7 @@
 #include "Renderer.h"
 #include "core/Time.h"
 #include "gl/RenderRegion.h"
+#include "gl/State.h"
 #include <vector>
 
 namespace fc {
@@ -23,6 +24,8 @@ private:
     fiv::ID _scrollSubscription;
 
     time::Moment _lastRenderTime;
+    // The change generation when the last frame was rendered
+    uint64_t _renderedGeneration = 0;
 
 public:
     Display(Window& window)
@@ -30,7 +33,7 @@ public:
           _window(window),
           _focusedElement(nullptr),
           _lastRenderTime(time::now()) {
-        glEnable(GL_SCISSOR_TEST);
+        gl::State::enable(GL_SCISSOR_TEST);
 
         _keySubscription = _window.getInput().subscripeKeyEvent(
             [this](input::RawKeyboardEvent event) { keyCallback(event); });
@@ -65,6 +68,15 @@ public:
         return alignment.getPixelSize(static_cast<glm::vec2>(_window.dimensions()));
     }
 
+    // Whether anything was marked dirty, or the window content lost, since the last frame was
+    // rendered. If not, the last frame is still on screen, and both rendering and displaying
+    // the window can be skipped.
+    bool needsRender() {
+        if (_window.isContentLost())
+            markDirty();
+        return changeGeneration() > _renderedGeneration;
+    }
+
     void render() {
         time::Moment now = time::now();
         time::Duration delta = now - _lastRenderTime;
@@ -74,7 +86,12 @@ public:
     }
 
     void render(const Window& window, time::Duration delta) override {
-        glDisable(GL_DEPTH_TEST);
+        // The window or anything else may have changed since the last frame
+        invalidateLayout();
+        // Elements marked dirty while rendering are rendered again in the next frame
+        _renderedGeneration = currentChangeGeneration();
+
+        gl::State::disable(GL_DEPTH_TEST);
 
         // Reset the viewport and scissor
         gl::RenderRegion::push({getPixelPosition(), getPixelSize()});
@@ -118,6 +135,8 @@ private:
     }
 
     void keyCallback(input::RawKeyboardEvent event) {
+        invalidateLayout();
+
         if (_focusedElement == nullptr)
             return;
         input::KeyboardEvent e = static_cast<input::KeyboardEvent>(event);
@@ -125,12 +144,16 @@ private:
     }
 
     void charCallback(input::UnicodeCodePoint letter) {
+        invalidateLayout();
+
         if (_focusedElement == nullptr)
             return;
         _focusedElement->onLetterTyped(_window.getInput(), letter);
     }
 
     void mouseButtonCallback(input::RawMouseButtonEvent event) {
+        invalidateLayout();
+
         const bool mouseIsLocked = _window.isMouseLocked();
         const glm::vec2 mousePos = _window.getInput().mouse();
 
@@ -164,6 +187,8 @@ private:
     }
 
     void mouseMotionCallback(input::RawMouseMotionEvent event) {
+        invalidateLayout();
+
         const bool mouseIsLocked = _window.isMouseLocked();
 
         if (!mouseIsLocked) {
@@ -196,6 +221,8 @@ private:
     }
 
     void scrollCallback(input::RawScrollEvent event) {
+        invalidateLayout();
+
         const bool mouseIsLocked = _window.isMouseLocked();
         if (!mouseIsLocked) {
             input::ScrollEvent e = static_cast<input::ScrollEvent>(event);
@@ -5,17 +5,32 @@ fc::Element::Element(alignment::ElementAlignment alignment)
     : alignment(alignment), _parent(nullptr), _hasFocus(false), focusable(false) {}
 
 glm::vec2 fc::Element::getPixelPosition() const {
-    return parent().calculateChildPixelPosition(alignment);
+    if (_positionGeneration != s_LayoutGeneration) {
+        _cachedPosition = parent().calculateChildPixelPosition(alignment);
+        _positionGeneration = s_LayoutGeneration;
+    }
+    return _cachedPosition;
 }
 
 glm::vec2 fc::Element::getPixelSize() const {
-    return parent().calculateChildPixelSize(alignment);
+    if (_sizeGeneration != s_LayoutGeneration) {
+        _cachedSize = parent().calculateChildPixelSize(alignment);
+        _sizeGeneration = s_LayoutGeneration;
+    }
+    return _cachedSize;
 }
 
 fc::Rectangle fc::Element::getPixelRectangle() const {
     return {getPixelPosition(), getPixelSize()};
 }
 
+void fc::Element::markDirty() {
+    s_ChangeGeneration++;
+    for (Element* element = this; element != nullptr; element = element->_parent) {
+        element->_changeGeneration = s_ChangeGeneration;
+    }
+}
+
 void fc::Element::unFocus() {
     _parent->unFocus();
 }
@@ -43,16 +43,37 @@ protected:
     // Whether this element can be focused or not.
     bool focusable;
 
+    // Changes every time the layout is invalidated. Can be used to cache layout results.
+    static uint64_t layoutGeneration() { return s_LayoutGeneration; }
+
 public:
     alignment::ElementAlignment alignment;
 
     Element(alignment::ElementAlignment alignment);
 
+    // The position and size are cached until the layout is invalidated, so repeated queries
+    // during a frame are O(1)
     virtual glm::vec2 getPixelPosition() const;
     virtual glm::vec2 getPixelSize() const;
 
     Rectangle getPixelRectangle() const;
 
+    // Invalidates the cached position and size of every element. Must be called after changing
+    // anything an alignment depends on, unless it is done between frames: the Display
+    // invalidates the layout before every frame and input event.
+    static void invalidateLayout() { s_LayoutGeneration++; }
+
+    // Marks this element and its ancestors as changed, so that the Display knows to render the
+    // next frame. Elements call this when their appearance changes. Code that changes the
+    // public fields or the alignment of an element directly should call it as well.
+    void markDirty();
+
+    // The change generation at which this element or one of its descendants was last marked
+    // dirty. Anything rendered before then is out of date.
+    uint64_t changeGeneration() const { return _changeGeneration; }
+    // Increases every time an element is marked dirty
+    static uint64_t currentChangeGeneration() { return s_ChangeGeneration; }
+
     // This is only called when the mouse is over this element,
     // so there is no need to check if the mouse position is within the
     // element's rectangle.
@@ -75,6 +96,17 @@ public:
 private:
     bool _hasFocus;
 
+    // Caches are valid while their generation matches the layout generation
+    static inline uint64_t s_LayoutGeneration = 1;
+    mutable uint64_t _positionGeneration = 0;
+    mutable uint64_t _sizeGeneration = 0;
+    mutable glm::vec2 _cachedPosition;
+    mutable glm::vec2 _cachedSize;
+
+    // New elements start out dirty
+    static inline uint64_t s_ChangeGeneration = 1;
+    uint64_t _changeGeneration = 1;
+
     virtual int32_t maxDepth() const { return calculateDepth(); }
 
     friend class Container;
@@ -4,6 +4,7 @@
 #include "HorisontalCenterer.h"
 #include "PlainGraph.h"
 #include "Text.h"
+#include "gl/State.h"
 
 namespace fc {
 class Graph : public Container {
@@ -35,7 +36,7 @@ public:
     }
 
     virtual void render(const Window& window, time::Duration delta) override {
-        glDisable(GL_DEPTH_TEST);
+        gl::State::disable(GL_DEPTH_TEST);
 
         background.render(window, delta);
         graph.render(window, delta);
@@ -44,9 +45,10 @@ public:
 
     void setData(const std::vector<glm::vec2>& data) {
         graph.data = data;
+        graph.markDirty();
 
         if (data.size() == 0) {
-            minMaxText.text = "Min: N/A Max: N/A";
+            minMaxText.setText("Min: N/A Max: N/A");
             return;
         }
 
@@ -57,7 +59,8 @@ public:
                                    return a.y < b.y;
                                })->y;
 
-        minMaxText.text = "Min: " + std::to_string(dataMinY) + " Max: " + std::to_string(dataMaxY);
+        minMaxText.setText("Min: " + std::to_string(dataMinY) + " Max: "
+                           + std::to_string(dataMaxY));
     }
 };
 } // namespace fc
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Container.h"
+#include <vector>
 
 namespace fc {
 class HorisontalPositioning : public Container {
@@ -19,12 +20,7 @@ public:
     void childCreated(fiv::ID id) override {
         children()[id]->alignment.x
             = alignment::AlignmentFunction([id, this](float parent1, float parent2) -> float {
-                  float xOffset = 0.0f;
-                  auto index = children().indexOf(id);
-                  for (size_t i = 0; i < index; i++) {
-                      const float childWidth = children().dataAt(i)->getPixelSize().x;
-                      xOffset += childWidth + (childWidth > 0 ? spacing : 0);
-                  }
+                  const float xOffset = childOffset(children().indexOf(id));
 
                   if (direction == Direction::LeftToRight) {
                       return xOffset;
@@ -33,5 +29,26 @@ public:
                   }
               });
     }
+
+protected:
+    // The distance from the start of the container to the child at the given index
+    float childOffset(size_t index) const {
+        if (_offsetsGeneration != layoutGeneration() || _offsets.size() != children().size()) {
+            // Prefix sum of the child widths, computed once per layout
+            _offsets.resize(children().size());
+            float xOffset = 0.0f;
+            for (size_t i = 0; i < children().size(); i++) {
+                _offsets[i] = xOffset;
+                const float childWidth = children().dataAt(i)->getPixelSize().x;
+                xOffset += childWidth + (childWidth > 0 ? spacing : 0);
+            }
+            _offsetsGeneration = layoutGeneration();
+        }
+        return _offsets[index];
+    }
+
+private:
+    mutable std::vector<float> _offsets;
+    mutable uint64_t _offsetsGeneration = 0;
 };
 } // namespace fc
\ No newline at end of file
@@ -5,6 +5,8 @@
 namespace fc {
 class Renderer {
 public:
+    virtual ~Renderer() = default;
+
     virtual void beforeRender(const fc::Window& window) = 0;
     virtual void afterRender(const fc::Window& window) = 0;
 };
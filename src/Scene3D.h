@@ -3,6 +3,8 @@
 #include "ColoredRect.h"
 #include "Container.h"
 #include "FreeCamera.h"
+#include "gl/FrameConstants.h"
+#include "gl/RenderQueue.h"
 #include "gl/RenderRegion.h"
 #include "res/ResourceManager.h"
 
@@ -13,6 +15,14 @@ public:
     std::unique_ptr<FreeCamera> camera;
     Light light;
     ColoredRect& background;
+    // Draws the models from a shared mesh pool with multi-draw indirect, which suits scenes of
+    // many meshes that stay loaded
+    bool multiDrawIndirect = false;
+
+private:
+    gl::FrameConstants _frameConstants;
+    gl::RenderQueue _renderQueue;
+    std::unique_ptr<gl::MeshPool> _meshPool;
 
 public:
     Scene3D(alignment::ElementAlignment alignment, ShapeRenderer2D& renderer)
@@ -27,21 +37,41 @@ public:
         // --- Handle input ---
         if (hasFocus() && camera) {
             camera->handleInput(window.getInput(), window, delta);
+            // The camera may move every frame while the scene is focused
+            markDirty();
         }
 
         // --- Render ---
         Container::render(window, delta);
 
         gl::RenderRegion::push(getPixelRectangle());
-        // Draw
+
+        // The camera and the light are uploaded once, and shared by every model
+        const Rectangle viewport = gl::RenderRegion::currentViewport();
+        const float aspectRatio = viewport.width / viewport.height;
+        _frameConstants.update(*camera, light, aspectRatio);
+
+        // Draw the visible submeshes of all models together, sorted to share state
+        _renderQueue.clear(camera->viewMatrix(), camera->projectionMatrix(aspectRatio));
         for (const auto& model : models) {
             if (model) {
-                model->render(window, *camera, light);
+                _renderQueue.add(*model);
             }
         }
+        if (multiDrawIndirect) {
+            if (!_meshPool) {
+                _meshPool = std::make_unique<gl::MeshPool>();
+            }
+            _renderQueue.submitIndirect(_frameConstants, *_meshPool);
+        } else {
+            _renderQueue.submit(_frameConstants);
+        }
         gl::RenderRegion::pop();
     }
 
+    // What drawing the models took in the last frame
+    const gl::RenderQueue::Stats& renderStats() const { return _renderQueue.stats(); }
+
     virtual void onKeyboardEvent(Input& input, input::KeyboardEvent event) override {
         if (event.action == input::KeyAction::Press && event.key == GLFW_KEY_ESCAPE) {
             unFocus();
@@ -72,10 +72,15 @@ public:
         }
 
         _flexElement.alignment.setHeight(alignment::Pixels(_verticalScrollOffset));
+        invalidateLayout();
+        markDirty();
     }
 
     // Scrolls to the top
-    void goToTop() { _verticalScrollOffset = 0.0f; }
+    void goToTop() {
+        _verticalScrollOffset = 0.0f;
+        markDirty();
+    }
 
     // Scrolls to the bottom
     void goToBottom() {
@@ -87,14 +92,14 @@ public:
         scroll(event.offset.y);
     }
 
-    float contentHeight() const {
-        float totalHeight = 0;
-        for (const auto& child : children()) {
-            totalHeight += child->getPixelSize().y;
-        }
-        return totalHeight - _flexElement.getPixelSize().y;
-    }
+    float contentHeight() const { return contentLength() - _flexElement.getPixelSize().y; }
 
     float getScrollOffset() const { return _verticalScrollOffset; }
+
+protected:
+    // Only the children that overlap the visible area are rendered and hit-tested
+    virtual std::pair<size_t, size_t> visibleChildRange() const override {
+        return childrenInRange(0.0f, getPixelSize().y);
+    }
 };
 } // namespace fc
\ No newline at end of file
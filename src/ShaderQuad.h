@@ -2,7 +2,9 @@
 
 #include "Element.h"
 #include "gl/IndexBuffer.h"
+#include "gl/RenderRegion.h"
 #include "gl/Shader.h"
+#include "gl/State.h"
 #include "gl/VertexArray.h"
 #include "gl/VertexBuffer.h"
 #include "gl/VertexBufferLayout.h"
@@ -14,6 +16,9 @@ public:
     gl::Shader shader;
 
     std::function<void(gl::Shader&)> beforeRender;
+    // Set for shaders that change over time, so that the quad is rendered every frame even
+    // when nothing else changes
+    bool animated = false;
 
 private:
     gl::VertexArray m_VAO;
@@ -84,11 +89,16 @@ public:
         : ShaderQuad(alignment, shaderCode, nullptr) {}
 
     void render(const Window& window, time::Duration delta) override {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // Pushing the region makes batching renderers draw what lies beneath the quad first
+        const Rectangle rect = getPixelRectangle();
+        gl::RenderRegion::push(rect, gl::RenderRegion::Mode::Scissor);
 
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+        gl::State::enable(GL_BLEND);
+        gl::State::blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                                     GL_ONE_MINUS_SRC_ALPHA);
+
+        gl::State::enable(GL_CULL_FACE);
+        gl::State::cullFace(GL_BACK);
 
         shader.bind();
 
@@ -100,8 +110,8 @@ public:
         shader.setUniformMat4f("projection", projection);
 
         glm::mat4 transform = glm::mat4(1.0f);
-        transform = glm::translate(transform, glm::vec3(getPixelPosition(), 0.0f));
-        transform = glm::scale(transform, glm::vec3(getPixelSize(), 1.0f));
+        transform = glm::translate(transform, glm::vec3(rect.position, 0.0f));
+        transform = glm::scale(transform, glm::vec3(rect.size, 1.0f));
         shader.setUniformMat4f("transform", transform);
 
         m_VAO.bind();
@@ -110,6 +120,11 @@ public:
                        nullptr);
         m_VAO.unbind();
         m_IBO.unbind();
+
+        gl::RenderRegion::pop();
+
+        if (animated)
+            markDirty();
     }
 };
 } // namespace fc
\ No newline at end of file
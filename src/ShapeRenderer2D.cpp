@@ -1,6 +1,8 @@
 #include "ShapeRenderer2D.h"
 #include "core/Maths.h"
 #include "generators/RoundedRectGenerator.h"
+#include "gl/RenderRegion.h"
+#include "gl/State.h"
 #include "gl/VertexBufferLayout.h"
 #include "glm/gtc/matrix_transform.hpp"
 
@@ -48,7 +50,21 @@ ShapeRenderer2D::ShapeRenderer2D() {
     m_Shader.addStageSource(GL_FRAGMENT_SHADER, FRAGMENT_SHADER_SOURCE);
     m_Shader.link();
     m_Shader.bind();
+    m_ViewProj = m_Shader.uniform("u_ViewProj");
 
+    m_VBO.reserve(1024 * sizeof(ShapeRenderer2D::Vertex), sizeof(ShapeRenderer2D::Vertex));
+    m_IBO.reserve(4096 * sizeof(GLuint), sizeof(GLuint));
+    setupVertexArray();
+
+    // The recorded shapes must be drawn with the region they were recorded in
+    m_RegionSubscription = gl::RenderRegion::subscribeChange([this]() { flush(); });
+}
+
+ShapeRenderer2D::~ShapeRenderer2D() {
+    gl::RenderRegion::unsubscribeChange(m_RegionSubscription);
+}
+
+void ShapeRenderer2D::setupVertexArray() {
     m_VAO.bind();
 
     gl::VertexBufferLayout layout;
@@ -65,44 +81,77 @@ ShapeRenderer2D::ShapeRenderer2D() {
 
 void ShapeRenderer2D::beforeRender(const Window& window) {}
 
-void ShapeRenderer2D::afterRender(const Window& window) {}
+void ShapeRenderer2D::afterRender(const Window& window) {
+    flush();
+}
 
-void ShapeRenderer2D::renderFan(const Window& window, const std::vector<Vertex>& vertices) {
-    if (vertices.size() < 3)
-        return;
+GLuint ShapeRenderer2D::beginShape(const Window& window, GLenum mode, GLsizei indexCount) {
+    m_Window = &window;
 
-    std::vector<GLuint> indices;
-    const GLuint numTriangles = static_cast<GLuint>(vertices.size()) - 2;
-    indices.reserve(numTriangles * 3);
-    for (GLuint triangle = 1; triangle < numTriangles + 1; triangle++) {
-        indices.push_back(0);
-        indices.push_back(triangle);
-        indices.push_back(triangle + 1);
+    if (m_DrawCalls.empty() || m_DrawCalls.back().mode != mode) {
+        m_DrawCalls.push_back({mode, static_cast<GLsizei>(m_Indices.size()), 0});
     }
+    m_DrawCalls.back().count += indexCount;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    return static_cast<GLuint>(m_Vertices.size());
+}
 
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+void ShapeRenderer2D::flush() {
+    if (m_Indices.empty() || m_Window == nullptr)
+        return;
+
+    gl::State::enable(GL_BLEND);
+    gl::State::blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                                 GL_ONE_MINUS_SRC_ALPHA);
 
-    glDisable(GL_DEPTH_TEST);
+    gl::State::enable(GL_CULL_FACE);
+    gl::State::cullFace(GL_BACK);
 
-    m_IBO.setIndices(indices.data(), static_cast<GLsizei>(indices.size()));
+    gl::State::disable(GL_DEPTH_TEST);
 
-    const int width = window.width();
-    const int height = window.height();
-    auto projection = window.orthographicProjection();
+    const GLsizeiptr vertexBytes = m_Vertices.size() * sizeof(ShapeRenderer2D::Vertex);
+    const GLsizeiptr indexBytes = m_Indices.size() * sizeof(GLuint);
 
-    m_VBO.setData(vertices.data(), vertices.size() * sizeof(ShapeRenderer2D::Vertex),
-                  GL_STREAM_DRAW);
+    const bool vboRecreated = m_VBO.reserve(vertexBytes, sizeof(ShapeRenderer2D::Vertex));
+    const bool iboRecreated = m_IBO.reserve(indexBytes, sizeof(GLuint));
+    if (vboRecreated || iboRecreated) {
+        setupVertexArray();
+    }
+
+    const GLintptr vertexOffset
+        = m_VBO.write(m_Vertices.data(), vertexBytes, sizeof(ShapeRenderer2D::Vertex));
+    const GLintptr indexOffset = m_IBO.write(m_Indices.data(), indexBytes, sizeof(GLuint));
+    const GLint baseVertex = static_cast<GLint>(vertexOffset / sizeof(ShapeRenderer2D::Vertex));
 
     m_Shader.bind();
+    m_ViewProj.set(m_Window->orthographicProjection());
 
-    m_Shader.setUniformMat4f("u_ViewProj", projection);
     m_VAO.bind();
     m_IBO.bind();
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    for (const DrawCall& drawCall : m_DrawCalls) {
+        const GLintptr offset = indexOffset + drawCall.first * sizeof(GLuint);
+        glDrawElementsBaseVertex(drawCall.mode, drawCall.count, GL_UNSIGNED_INT,
+                                 reinterpret_cast<const void*>(offset), baseVertex);
+    }
+
+    m_Vertices.clear();
+    m_Indices.clear();
+    m_DrawCalls.clear();
+}
+
+void ShapeRenderer2D::renderFan(const Window& window, const std::vector<Vertex>& vertices) {
+    if (vertices.size() < 3)
+        return;
+
+    const GLuint numTriangles = static_cast<GLuint>(vertices.size()) - 2;
+    const GLuint first = beginShape(window, GL_TRIANGLES, numTriangles * 3);
+
+    m_Vertices.insert(m_Vertices.end(), vertices.begin(), vertices.end());
+    for (GLuint triangle = 1; triangle < numTriangles + 1; triangle++) {
+        m_Indices.push_back(first);
+        m_Indices.push_back(first + triangle);
+        m_Indices.push_back(first + triangle + 1);
+    }
 }
 
 void ShapeRenderer2D::rect(const Window& window, glm::vec2 position, glm::vec2 scale,
@@ -111,29 +160,20 @@ void ShapeRenderer2D::rect(const Window& window, glm::vec2 position, glm::vec2 s
         return;
 
     const GLuint packedColor = packColor(color);
+    const GLuint first = beginShape(window, GL_TRIANGLES, 6);
 
-    ShapeRenderer2D::Vertex v1;
-    v1.position = glm::vec2(0, 0) * scale + position;
-    v1.RGBA = packedColor;
-
-    ShapeRenderer2D::Vertex v2;
-    v2.position = glm::vec2(1, 0) * scale + position;
-    v2.RGBA = packedColor;
+    m_Vertices.push_back({glm::vec2(0, 0) * scale + position, packedColor});
+    m_Vertices.push_back({glm::vec2(1, 0) * scale + position, packedColor});
+    m_Vertices.push_back({glm::vec2(1, 1) * scale + position, packedColor});
+    m_Vertices.push_back({glm::vec2(0, 1) * scale + position, packedColor});
 
-    ShapeRenderer2D::Vertex v3;
-    v3.position = glm::vec2(1, 1) * scale + position;
-    v3.RGBA = packedColor;
-
-    ShapeRenderer2D::Vertex v4;
-    v4.position = glm::vec2(0, 1) * scale + position;
-    v4.RGBA = packedColor;
-
-    renderFan(window, {v1, v2, v3, v4});
+    m_Indices.insert(m_Indices.end(),
+                     {first, first + 1, first + 2, first, first + 2, first + 3});
 }
 
 void fc::ShapeRenderer2D::roundedRect(const Window& window, glm::vec2 position, glm::vec2 scale,
                                       glm::vec4 color, float radius, uint32_t quality) {
-    if (scale.x <= 0 || scale.y <= 0)
+    if (scale.x <= 0 || scale.y <= 0 || quality < 3)
         return;
 
     if (radius * 2.0f > scale.x) {
@@ -143,31 +183,40 @@ void fc::ShapeRenderer2D::roundedRect(const Window& window, glm::vec2 position,
         radius = scale.y / 2.0f;
     }
 
-    std::vector<ShapeRenderer2D::Vertex> vertices;
     const GLuint packedColor = packColor(color);
+    const GLuint first = beginShape(window, GL_TRIANGLES, (quality - 2) * 3);
 
     RoundedRectGenerator generator(scale, radius, quality);
     for (uint32_t i = 0; i < quality; i++) {
-        vertices.push_back({generator.getPoint(i) + position, packedColor});
+        m_Vertices.push_back({generator.getPoint(i) + position, packedColor});
+    }
+    for (GLuint triangle = 1; triangle < quality - 1; triangle++) {
+        m_Indices.push_back(first);
+        m_Indices.push_back(first + triangle);
+        m_Indices.push_back(first + triangle + 1);
     }
-
-    renderFan(window, vertices);
 }
 
 void ShapeRenderer2D::circle(const Window& window, glm::vec2 center, float radius, glm::vec4 color,
                              uint32_t quality) {
+    if (quality < 3)
+        return;
+
     if (radius < 0)
         radius = -radius;
 
-    std::vector<ShapeRenderer2D::Vertex> vertices;
     const GLuint packedColor = packColor(color);
+    const GLuint first = beginShape(window, GL_TRIANGLES, (quality - 2) * 3);
 
     CircleGenerator generator(radius, quality);
     for (uint32_t i = 0; i < quality; i++) {
-        vertices.push_back({generator.getPoint(i) + center, packedColor});
+        m_Vertices.push_back({generator.getPoint(i) + center, packedColor});
+    }
+    for (GLuint triangle = 1; triangle < quality - 1; triangle++) {
+        m_Indices.push_back(first);
+        m_Indices.push_back(first + triangle);
+        m_Indices.push_back(first + triangle + 1);
     }
-
-    renderFan(window, vertices);
 }
 
 void ShapeRenderer2D::lineStrip(const Window& window, std::vector<glm::vec2> points,
@@ -176,8 +225,8 @@ void ShapeRenderer2D::lineStrip(const Window& window, std::vector<glm::vec2> poi
         return;
 
     const GLuint packedColor = packColor(color);
-    std::vector<ShapeRenderer2D::Vertex> vertices;
-    std::vector<GLuint> indices;
+    const GLuint vertexCount = static_cast<GLuint>(points.size()) * 2;
+    const GLuint first = beginShape(window, GL_TRIANGLES, (vertexCount - 2) * 3);
 
     auto getNormal = [](const glm::vec2& a, const glm::vec2& b) {
         glm::vec2 dir = glm::normalize(b - a);
@@ -213,60 +262,30 @@ void ShapeRenderer2D::lineStrip(const Window& window, std::vector<glm::vec2> poi
         }
 
         glm::vec2 offset = miter * (thickness * 0.5f * miterLen);
-        vertices.push_back({points[i] + offset, packedColor});
-        vertices.push_back({points[i] - offset, packedColor});
+        m_Vertices.push_back({points[i] + offset, packedColor});
+        m_Vertices.push_back({points[i] - offset, packedColor});
     }
 
-    // Indices for triangle strip
-    for (GLuint i = 0; i < vertices.size(); ++i) {
-        indices.push_back(i);
+    // Unroll the triangle strip into a triangle list, flipping every other triangle
+    // the same way GL_TRIANGLE_STRIP does to keep a consistent winding
+    for (GLuint i = 0; i < vertexCount - 2; ++i) {
+        if (i % 2 == 0) {
+            m_Indices.insert(m_Indices.end(), {first + i, first + i + 1, first + i + 2});
+        } else {
+            m_Indices.insert(m_Indices.end(), {first + i + 1, first + i, first + i + 2});
+        }
     }
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    m_IBO.setIndices(indices.data(), static_cast<GLsizei>(indices.size()));
-
-    auto projection = window.orthographicProjection();
-    m_VBO.setData(vertices.data(), vertices.size() * sizeof(ShapeRenderer2D::Vertex),
-                  GL_STREAM_DRAW);
-
-    m_Shader.bind();
-    m_Shader.setUniformMat4f("u_ViewProj", projection);
-
-    m_VAO.bind();
-    m_IBO.bind();
-    glDrawElements(GL_TRIANGLE_STRIP, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT,
-                   nullptr);
 }
+
 void ShapeRenderer2D::lineSegment(const Window& window, glm::vec2 point1, glm::vec2 point2,
                                   glm::vec4 color) {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
     const GLuint packedColor = packColor(color);
-    ShapeRenderer2D::Vertex v1{point1, packedColor};
-    ShapeRenderer2D::Vertex v2{point2, packedColor};
-    std::vector<ShapeRenderer2D::Vertex> vertices = {v1, v2};
-    std::vector<GLuint> indices = {0, 1};
+    const GLuint first = beginShape(window, GL_LINES, 2);
 
-    m_IBO.setIndices(indices.data(), static_cast<GLsizei>(indices.size()));
+    m_Vertices.push_back({point1, packedColor});
+    m_Vertices.push_back({point2, packedColor});
 
-    auto projection = window.orthographicProjection();
-    m_VBO.setData(vertices.data(), vertices.size() * sizeof(ShapeRenderer2D::Vertex),
-                  GL_STREAM_DRAW);
-
-    m_Shader.bind();
-    m_Shader.setUniformMat4f("u_ViewProj", projection);
-
-    m_VAO.bind();
-    m_IBO.bind();
-    glDrawElements(GL_LINES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    m_Indices.push_back(first);
+    m_Indices.push_back(first + 1);
 }
 } // namespace fc
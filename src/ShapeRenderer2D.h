@@ -5,6 +5,7 @@
 #include "fiv.hpp"
 #include "gl/IndexBuffer.h"
 #include "gl/Shader.h"
+#include "gl/StreamBuffer.h"
 #include "gl/VertexArray.h"
 #include "glm/glm.hpp"
 #include <array>
@@ -20,16 +21,39 @@ private:
                      // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
     };
 
+    // A range of the batched indices that is drawn with a single primitive mode.
+    struct DrawCall {
+        GLenum mode;
+        GLsizei first;
+        GLsizei count;
+    };
+
     GLuint packColor(glm::vec4 color);
 
+    // Makes room for a shape with the given primitive mode in the batch and returns the
+    // index its first vertex will get. The caller must push exactly indexCount indices.
+    GLuint beginShape(const Window& window, GLenum mode, GLsizei indexCount);
+
+    void setupVertexArray();
+
 private:
-    gl::IndexBuffer m_IBO;
-    gl::VertexBuffer m_VBO;
+    gl::StreamIndexBuffer m_IBO;
+    gl::StreamVertexBuffer m_VBO;
     gl::VertexArray m_VAO;
     gl::Shader m_Shader;
+    gl::Uniform m_ViewProj;
+
+    // The shapes recorded since the last flush
+    std::vector<Vertex> m_Vertices;
+    std::vector<GLuint> m_Indices;
+    std::vector<DrawCall> m_DrawCalls;
+    const Window* m_Window = nullptr;
+
+    fiv::ID m_RegionSubscription;
 
 public:
     ShapeRenderer2D();
+    ~ShapeRenderer2D();
 
     ShapeRenderer2D(const ShapeRenderer2D&) = delete;
     ShapeRenderer2D& operator=(const ShapeRenderer2D&) = delete;
@@ -37,6 +61,10 @@ public:
     void beforeRender(const fc::Window& window) override;
     void afterRender(const Window& window) override;
 
+    // Draws all shapes recorded since the last flush.
+    // This is done automatically after rendering and whenever the render region changes.
+    void flush();
+
     // Adds a shape with its vertices like a triangle fan
     // The vertices must be in a counterclockwise order
     void renderFan(const Window& window, const std::vector<Vertex>& vertices);
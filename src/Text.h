@@ -26,6 +26,7 @@ public:
     Tracked<float> textSize;
     Tracked<WrapMode> wrapMode{WrapMode::Wrap};
     Tracked<bool> wrapTightly{false};
+    // Prefer setText, which marks the element dirty
     std::string text;
 
 private:
@@ -44,7 +45,19 @@ public:
           color(textColor),
           defaultWidth(alignment.width),
           defaultHeight(alignment.height),
-          text(text) {}
+          text(text) {
+        color.onModified([this]() { markDirty(); });
+        this->textSize.onModified([this]() { markDirty(); });
+        wrapMode.onModified([this]() { markDirty(); });
+        wrapTightly.onModified([this]() { markDirty(); });
+    }
+
+    void setText(const std::string& newText) {
+        if (newText == text)
+            return;
+        text = newText;
+        markDirty();
+    }
 
     virtual void render(const Window& window, time::Duration delta) override {
         bool shouldRebuild = false;
@@ -73,7 +86,12 @@ public:
             return;
 
         const Rectangle rect = getPixelRectangle();
-        gl::RenderRegion::push(rect, gl::RenderRegion::Mode::Scissor);
+
+        // The renderer batches all text, so the clip is passed along instead of being pushed
+        const Rectangle clip = rect.intersection(gl::RenderRegion::currentScissor());
+        if (clip.width <= 0 || clip.height <= 0)
+            return;
+
         const glm::vec2 pos = rect.position;
         const glm::vec2 size = rect.size;
         const float top = pos.y + size.y;
@@ -85,11 +103,10 @@ public:
 
             // Only render if line is within vertical bounds
             if (lineY <= top && lineY >= bottom) {
-                renderer.renderText(window, line.first, glm::vec3(linePos, 0), textSize, color);
+                renderer.renderText(window, line.first, glm::vec3(linePos, 0), textSize, color,
+                                    clip);
             }
         }
-
-        gl::RenderRegion::pop();
     }
 
     void buildLinesCache() {
@@ -167,6 +184,10 @@ public:
             alignment.setHeight(defaultHeight);
         }
 
+        invalidateLayout();
+        // The new size only affects the layout from the next frame on
+        markDirty();
+
         // Offset the positions
         const glm::vec2 basePos = glm::vec2(0, getPixelSize().y);
         for (auto& line : _linesCache) {
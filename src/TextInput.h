@@ -33,7 +33,7 @@ public:
         std::string str = text.text;
         std::string newStr = str.substr(0, _cursorPosition) + static_cast<char>(letter)
                              + str.substr(_cursorPosition);
-        text.text = newStr;
+        text.setText(newStr);
         _cursorPosition++;
     }
 
@@ -54,11 +54,17 @@ public:
                            {3, lineHeight}, text.color);
         }
         cursorBlinkCounter++;
+
+        // Keep rendering while the cursor blinks
+        if (_showCursor)
+            markDirty();
     }
 
     virtual void onKeyboardEvent(Input& input, input::KeyboardEvent event) override {
         if (event.action == input::KeyAction::Press || event.action == input::KeyAction::Repeat) {
             cursorBlinkCounter = 0;
+            // The cursor moves or the text changes
+            markDirty();
 
             switch (event.key) {
             case GLFW_KEY_BACKSPACE:
@@ -68,7 +74,7 @@ public:
                     std::string str = text.text;
                     std::string newStr
                         = str.substr(0, _cursorPosition - 1) + str.substr(_cursorPosition);
-                    text.text = newStr;
+                    text.setText(newStr);
                     _cursorPosition--;
                     clampCursor();
                 }
@@ -79,7 +85,7 @@ public:
                     std::string str = text.text;
                     std::string newStr
                         = str.substr(0, _cursorPosition) + str.substr(_cursorPosition + 1);
-                    text.text = newStr;
+                    text.setText(newStr);
                 }
                 break;
 
@@ -87,7 +93,7 @@ public:
                 std::string str = text.text;
                 std::string newStr
                     = str.substr(0, _cursorPosition) + '\n' + str.substr(_cursorPosition);
-                text.text = newStr;
+                text.setText(newStr);
                 _cursorPosition++;
                 clampCursor();
                 break;
@@ -199,8 +205,8 @@ public:
             case GLFW_KEY_V: {
                 const char* clipboard = input.clipboard();
                 std::string str = text.text;
-                text.text
-                    = str.substr(0, _cursorPosition) + clipboard + str.substr(_cursorPosition);
+                text.setText(str.substr(0, _cursorPosition) + clipboard
+                             + str.substr(_cursorPosition));
                 break;
             }
 
@@ -213,8 +219,12 @@ public:
     virtual void onFocusAquired() override {
         _showCursor = true;
         cursorBlinkCounter = 0;
+        markDirty();
+    }
+    virtual void onFocusLost() override {
+        _showCursor = false;
+        markDirty();
     }
-    virtual void onFocusLost() override { _showCursor = false; }
 
     // Get the line the cursor is currently on
     uint32_t cursorLineNumber() const {
@@ -1,38 +1,64 @@
 #include "TextRenderer.h"
+#include "gl/RenderRegion.h"
+#include "gl/State.h"
 #include "gl/VertexBufferLayout.h"
+#include <algorithm>
 #include <cassert>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace fc {
 
+GLuint TextRenderer::packColor(glm::vec4 color) {
+    GLuint packedColor
+        = ((GLuint)(GLubyte)(color.r * 255) << 0) | ((GLuint)(GLubyte)(color.g * 255) << 8)
+          | ((GLuint)(GLubyte)(color.b * 255) << 16) | ((GLuint)(GLubyte)(color.a * 255) << 24);
+    return packedColor;
+}
+
 TextRenderer::TextRenderer(const std::string& fontPath) : _charset(fontPath) {
     // Compile the MSDF shader
     const char* VERTEX_SOURCE = R"(
         #version 330 core
         layout(location = 0) in vec3 pos;
         layout(location = 1) in vec2 uv;
+        layout(location = 2) in uint rgba;
+        layout(location = 3) in vec4 clip;
         out vec2 TexCoords;
+        out vec4 TextColor;
+        flat out vec4 ClipRect;
         uniform mat4 projection;
         void main() {
             gl_Position = projection * vec4(pos, 1.0);
             TexCoords = uv;
+            TextColor = vec4(float(rgba & 255u), float((rgba >> 8) & 255u),
+                             float((rgba >> 16) & 255u), float((rgba >> 24) & 255u)) / 255.0;
+            ClipRect = clip;
         }
     )";
 
     const char* FRAGMENT_SOURCE = R"(
         #version 330 core
         in vec2 TexCoords;
+        in vec4 TextColor;
+        flat in vec4 ClipRect; // minX, minY, maxX, maxY in window pixels
         out vec4 color;
 
         uniform sampler2D atlas;
-        uniform vec4 textColor;
+        // Where the render target starts in the window, to get window pixels from gl_FragCoord
+        uniform vec2 targetOrigin;
 
         float median(float r, float g, float b) {
             return max(min(r, g), min(max(r, g), b));
         }
 
         void main() {
+            vec2 windowCoord = gl_FragCoord.xy + targetOrigin;
+            if (windowCoord.x < ClipRect.x || windowCoord.y < ClipRect.y
+                || windowCoord.x > ClipRect.z || windowCoord.y > ClipRect.w) {
+                discard;
+            }
+
             vec3 msd = texture(atlas, TexCoords).rgb;
             float sd = median(msd.r, msd.g, msd.b);
             float pixelRange = 2.0; // This should be 2.0 (matching the packer.setPixelRange)
@@ -49,51 +75,79 @@ TextRenderer::TextRenderer(const std::string& fontPath) : _charset(fontPath) {
 
             float opacity = clamp((sd - 0.5) * screenPxRange + 0.5, 0.0, 1.0);
             
-            color = vec4(textColor.rgb, textColor.a * opacity);
+            color = vec4(TextColor.rgb, TextColor.a * opacity);
         }
     )";
 
     _textShader.addStageSource(GL_VERTEX_SHADER, VERTEX_SOURCE);
     _textShader.addStageSource(GL_FRAGMENT_SHADER, FRAGMENT_SOURCE);
     _textShader.link();
+    _projectionUniform = _textShader.uniform("projection");
+    _atlasUniform = _textShader.uniform("atlas");
+    _targetOriginUniform = _textShader.uniform("targetOrigin");
+
+    // Reserve enough space for a few strings (grows if needed)
+    _vbo.reserve(sizeof(Vertex) * 1024 * 6, sizeof(Vertex));
+    setupVertexArray();
+
+    // Text is batched across regions, but not across render targets
+    _targetSubscription = gl::RenderRegion::subscribeTargetChange([this]() { flush(); });
+}
+
+TextRenderer::~TextRenderer() {
+    gl::RenderRegion::unsubscribeTargetChange(_targetSubscription);
+}
 
-    // Setup VAO/VBO
+void TextRenderer::setupVertexArray() {
     _vao.bind();
     gl::VertexBufferLayout layout;
-    layout.push(GL_FLOAT, 3); // pos
-    layout.push(GL_FLOAT, 2); // uv
+    layout.push(GL_FLOAT, 3);        // pos
+    layout.push(GL_FLOAT, 2);        // uv
+    layout.push(GL_UNSIGNED_INT, 1); // color
+    layout.push(GL_FLOAT, 4);        // clip rectangle
     _vao.addBuffer(_vbo, layout);
-    _vbo.bind();
-    // Reserve enough space for one string (can grow dynamically if needed)
-    _vbo.setData(nullptr, sizeof(Vertex) * 1024 * 6, GL_DYNAMIC_DRAW);
     _vao.unbind();
     _vbo.unbind();
 }
 
 void TextRenderer::renderText(const Window& window, const std::string& text, glm::vec3 pos,
                               float scale, glm::vec4 color) {
-    renderText(static_cast<glm::vec2>(window.dimensions()), text, pos, scale, color);
+    renderText(window, text, pos, scale, color, gl::RenderRegion::currentScissor());
+}
+
+void TextRenderer::renderText(const Window& window, const std::string& text, glm::vec3 pos,
+                              float scale, glm::vec4 color, const Rectangle& clip) {
+    renderText(static_cast<glm::vec2>(window.dimensions()), text, pos, scale, color, clip);
 }
 
 void TextRenderer::renderText(glm::vec2 viewportSize, const std::string& text, glm::vec3 pos,
                               float scale, glm::vec4 color) {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glDisable(GL_DEPTH_TEST);
-
-    glm::mat4 projection = glm::ortho(0.0f, viewportSize.x, 0.0f, viewportSize.y);
+    renderText(viewportSize, text, pos, scale, color, gl::RenderRegion::currentScissor());
+}
 
-    _textShader.bind();
-    _textShader.setUniformMat4f("projection", projection);
-    _textShader.setUniform4f("textColor", color.x, color.y, color.z, color.w);
-    _textShader.setUniform1i("atlas", 0);
-    _charset.atlas().bind(0);
+void TextRenderer::renderText(glm::vec2 viewportSize, const std::string& text, glm::vec3 pos,
+                              float scale, glm::vec4 color, const Rectangle& clip) {
+    if (text.empty() || clip.width <= 0 || clip.height <= 0)
+        return;
+
+    // All glyphs in a batch share one projection
+    if (viewportSize != _viewportSize) {
+        flush();
+        _viewportSize = viewportSize;
+    }
 
-    _vao.bind();
+    const GLuint packedColor = packColor(color);
+    const glm::vec4 clipRect = {clip.x, clip.y, clip.x + clip.width, clip.y + clip.height};
 
-    std::vector<Vertex> vertices;
-    vertices.reserve(text.size() * 6);
+    // Make room for the whole string up front. The batch keeps its capacity between frames and
+    // grows geometrically, so long strings do not cause a reallocation every frame.
+    size_t vertexCount = _vertices.size();
+    const size_t requiredCount = vertexCount + text.size() * 6;
+    if (requiredCount > _vertices.capacity()) {
+        _vertices.reserve(std::max(requiredCount, _vertices.capacity() * 2));
+    }
+    _vertices.resize(requiredCount);
+    Vertex* vertices = _vertices.data();
 
     float x = pos.x;
     float y = pos.y;
@@ -109,34 +163,66 @@ void TextRenderer::renderText(glm::vec2 viewportSize, const std::string& text, g
         float w = glyph.size.x * scale;
         float h = glyph.size.y * scale;
 
-        // Inside TextRenderer.cpp
+        x += glyph.advance * scale;
+
+        // Glyphs entirely outside of the clip rectangle never produce any fragments
+        if (xpos > clipRect.z || xpos + w < clipRect.x || ypos > clipRect.w
+            || ypos + h < clipRect.y) {
+            continue;
+        }
+
         float u0 = glyph.uvMin.x; // Left
         float v0 = glyph.uvMin.y; // Bottom
         float u1 = glyph.uvMax.x; // Right
         float v1 = glyph.uvMax.y; // Top
 
         // Triangle 1
-        vertices.push_back({{xpos, ypos + h, pos.z}, {u0, v1}}); // Top Left
-        vertices.push_back({{xpos, ypos, pos.z}, {u0, v0}});     // Bottom Left
-        vertices.push_back({{xpos + w, ypos, pos.z}, {u1, v0}}); // Bottom Right
+        vertices[vertexCount++] = {{xpos, ypos + h, pos.z}, {u0, v1}, packedColor, clipRect};
+        vertices[vertexCount++] = {{xpos, ypos, pos.z}, {u0, v0}, packedColor, clipRect};
+        vertices[vertexCount++] = {{xpos + w, ypos, pos.z}, {u1, v0}, packedColor, clipRect};
 
         // Triangle 2
-        vertices.push_back({{xpos, ypos + h, pos.z}, {u0, v1}});     // Top Left
-        vertices.push_back({{xpos + w, ypos, pos.z}, {u1, v0}});     // Bottom Right
-        vertices.push_back({{xpos + w, ypos + h, pos.z}, {u1, v1}}); // Top Right
+        vertices[vertexCount++] = {{xpos, ypos + h, pos.z}, {u0, v1}, packedColor, clipRect};
+        vertices[vertexCount++] = {{xpos + w, ypos, pos.z}, {u1, v0}, packedColor, clipRect};
+        vertices[vertexCount++] = {{xpos + w, ypos + h, pos.z}, {u1, v1}, packedColor, clipRect};
+    }
 
-        x += glyph.advance * scale;
+    // Drop the slots of skipped characters
+    _vertices.resize(vertexCount);
+}
+
+void TextRenderer::flush() {
+    if (_vertices.empty())
+        return;
+
+    gl::State::enable(GL_BLEND);
+    gl::State::blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                                 GL_ONE_MINUS_SRC_ALPHA);
+
+    gl::State::disable(GL_DEPTH_TEST);
+
+    const GLsizeiptr vertexBytes = _vertices.size() * sizeof(Vertex);
+    if (_vbo.reserve(vertexBytes, sizeof(Vertex))) {
+        setupVertexArray();
     }
+    const GLintptr vertexOffset = _vbo.write(_vertices.data(), vertexBytes, sizeof(Vertex));
+
+    glm::mat4 projection = glm::ortho(0.0f, _viewportSize.x, 0.0f, _viewportSize.y);
+
+    _textShader.bind();
+    _projectionUniform.set(projection);
+    _atlasUniform.set(0);
+    _targetOriginUniform.set(gl::RenderRegion::targetOrigin());
+    _charset.atlas().bind(0);
 
-    // Upload all vertices at once
-    _vbo.bind();
-    _vbo.editData(vertices.data(), 0, vertices.size() * sizeof(Vertex));
     _vao.bind();
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(vertexOffset / sizeof(Vertex)),
+                 static_cast<GLsizei>(_vertices.size()));
 
     _vao.unbind();
-    _vbo.unbind();
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl::Texture2D::unbind();
+
+    _vertices.clear();
 }
 
 float TextRenderer::width(const std::string& text, float scale) {
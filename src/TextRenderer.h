@@ -2,15 +2,17 @@
 #include "Charset.h"
 #include "Renderer.h"
 #include "Window.h"
+#include "core/Rectangle.h"
 #include "fiv.hpp"
 #include "gl/Shader.h"
+#include "gl/StreamBuffer.h"
 #include "gl/Texture2D.h"
 #include "gl/VertexArray.h"
-#include "gl/VertexBuffer.h"
 #include "glm/glm.hpp"
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace fc {
 class TextRenderer : public Renderer {
@@ -18,25 +20,53 @@ private:
     struct Vertex {
         glm::vec3 pos;
         glm::vec2 texCoord;
+        GLuint RGBA; // A color packed into a uint (32 bit) in the format:
+                     // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+        glm::vec4 clip; // minX, minY, maxX, maxY in window pixels
     };
 
+    static GLuint packColor(glm::vec4 color);
+
 private:
     gl::Shader _textShader;
+    gl::Uniform _projectionUniform;
+    gl::Uniform _atlasUniform;
+    gl::Uniform _targetOriginUniform;
     gl::VertexArray _vao;
-    gl::VertexBuffer _vbo;
+    gl::StreamVertexBuffer _vbo;
 
     Charset _charset;
 
+    // The glyphs recorded since the last flush
+    std::vector<Vertex> _vertices;
+    glm::vec2 _viewportSize{0.0f, 0.0f};
+
+    fiv::ID _targetSubscription;
+
+    void setupVertexArray();
+
 public:
     TextRenderer(const std::string& fontPath);
+    ~TextRenderer();
 
     TextRenderer(const TextRenderer&) = delete;
     TextRenderer& operator=(const TextRenderer&) = delete;
 
+    // Records the text. All text is drawn in a single draw call when the renderer is flushed,
+    // which happens after rendering. Fragments outside of the clip rectangle are discarded.
+    // If no clip rectangle is given, the current scissor of gl::RenderRegion is used.
     void renderText(const Window& window, const std::string& text, glm::vec3 pos, float scale,
                     glm::vec4 color);
+    void renderText(const Window& window, const std::string& text, glm::vec3 pos, float scale,
+                    glm::vec4 color, const Rectangle& clip);
     void renderText(glm::vec2 viewportSize, const std::string& text, glm::vec3 pos, float scale,
                     glm::vec4 color);
+    void renderText(glm::vec2 viewportSize, const std::string& text, glm::vec3 pos, float scale,
+                    glm::vec4 color, const Rectangle& clip);
+
+    // Draws all text recorded since the last flush
+    void flush();
+
     float width(const std::string& text, float scale);
     float height(const std::string& text, float scale);
     float lineHeight(float scale);
@@ -44,6 +74,6 @@ public:
     float ascenderHeight(float scale);
 
     virtual void beforeRender(const fc::Window& window) {}
-    virtual void afterRender(const fc::Window& window) {}
+    virtual void afterRender(const fc::Window& window) { flush(); }
 };
 } // namespace fc
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "TexturedBatchRenderer.h"
+#include "gl/State.h"
 #include "gl/Texture2D.h"
+#include <stdexcept>
 #include "glm/gtc/matrix_transform.hpp"
 
 static constexpr const char* VERTEX_SOURCE = R"(
@@ -37,6 +39,43 @@ void main() {
 }
 )";
 
+static constexpr const char* INSTANCED_VERTEX_SOURCE = R"(
+#version 450 core
+layout (location = 0) in vec2 a_Position;
+layout (location = 1) in vec2 a_Scale;
+layout (location = 2) in uint a_RGBA;
+layout (location = 3) in uint a_TexID;
+
+uniform mat4 u_ViewProj;
+uniform mat4 u_Transform;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out uint v_TexID;
+
+// The quad is drawn as a triangle strip
+const vec2 corners[4] = {
+	vec2(-0.5, -0.5),
+	vec2( 0.5, -0.5),
+	vec2(-0.5,  0.5),
+	vec2( 0.5,  0.5),
+};
+
+void main() {
+	uint r =  a_RGBA        & 255;
+	uint g = (a_RGBA >> 8)  & 255;
+	uint b = (a_RGBA >> 16) & 255;
+	uint a = (a_RGBA >> 24) & 255;
+	v_Color = vec4(float(r) / 255.0, float(g) / 255.0, float(b) / 255.0, float(a) / 255.0);
+
+	vec2 corner = corners[gl_VertexID];
+	v_TexCoord = corner + 0.5;
+	v_TexID = a_TexID;
+
+	gl_Position = u_ViewProj * u_Transform * vec4(corner * a_Scale + a_Position, 0.0, 1.0);
+}
+)";
+
 static constexpr const char* FRAGMENT_SOURCE = R"(
 #version 450 core
 
@@ -53,10 +92,54 @@ void main() {
 }
 )";
 
+static constexpr const char* ARRAY_FRAGMENT_SOURCE = R"(
+#version 450 core
+
+layout (location=0) out vec4 o_Color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in uint v_TexID;
+
+uniform sampler2DArray u_TextureArray;
+
+void main() {
+	o_Color = texture(u_TextureArray, vec3(v_TexCoord, float(v_TexID))) * v_Color;
+}
+)";
+
+static constexpr const char* ATLAS_FRAGMENT_SOURCE = R"(
+#version 450 core
+
+layout (location=0) out vec4 o_Color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in uint v_TexID;
+
+struct Region {
+	vec4 uvRect;
+	uint page;
+};
+
+layout (std430, binding = 0) readonly buffer Regions {
+	Region u_Regions[];
+};
+
+uniform sampler2DArray u_TextureArray;
+
+void main() {
+	Region region = u_Regions[v_TexID];
+	vec2 uv = mix(region.uvRect.xy, region.uvRect.zw, v_TexCoord);
+	o_Color = texture(u_TextureArray, vec3(uv, float(region.page))) * v_Color;
+}
+)";
+
 namespace fc {
 
 void TexturedBatchRenderer::createIndicesForQuads(const size_t quadCount) {
-    if (quadCount * INDICES_PER_QUAD == indices.size())
+    // The index pattern is the same for every quad, so the buffer only has to grow
+    if (quadCount * INDICES_PER_QUAD <= indices.size())
         return;
     indices.resize(quadCount * INDICES_PER_QUAD);
 
@@ -79,9 +162,7 @@ void TexturedBatchRenderer::createIndicesForQuads(const size_t quadCount) {
 std::array<TexturedBatchRenderer::Vertex, 4>
 TexturedBatchRenderer::createQuad(const glm::vec2 position, const glm::vec2 scale,
                                   const glm::vec4 color, const uint32_t textureID) {
-    GLuint packedColor
-        = ((GLuint)(GLubyte)(color.r * 255) << 0) | ((GLuint)(GLubyte)(color.g * 255) << 8)
-          | ((GLuint)(GLubyte)(color.b * 255) << 16) | ((GLuint)(GLubyte)(color.a * 255) << 24);
+    GLuint packedColor = packColor(color);
 
     GLuint texID = textureID << 2;
 
@@ -108,19 +189,58 @@ TexturedBatchRenderer::createQuad(const glm::vec2 position, const glm::vec2 scal
     return {v1, v2, v3, v4};
 }
 
-TexturedBatchRenderer::TexturedBatchRenderer(Window& window, res::ResourceManager& resourceManager)
-    : resourceManager(resourceManager) {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+GLuint TexturedBatchRenderer::packColor(const glm::vec4 color) {
+    return ((GLuint)(GLubyte)(color.r * 255) << 0) | ((GLuint)(GLubyte)(color.g * 255) << 8)
+           | ((GLuint)(GLubyte)(color.b * 255) << 16) | ((GLuint)(GLubyte)(color.a * 255) << 24);
+}
+
+TexturedBatchRenderer::TexturedBatchRenderer(Window& window, res::ResourceManager& resourceManager,
+                                             Mode mode, TextureStorage textureStorage)
+    : mode(mode), textureStorage(textureStorage), resourceManager(resourceManager) {
+    gl::State::enable(GL_BLEND);
+    gl::State::blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                                 GL_ONE_MINUS_SRC_ALPHA);
 
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+    gl::State::enable(GL_CULL_FACE);
+    gl::State::cullFace(GL_BACK);
 
     int width = window.width();
     int height = window.height();
-    shader = resourceManager.loadShaderSource(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    const char* fragmentSource = FRAGMENT_SOURCE;
+    if (textureStorage == TextureStorage::Array) {
+        fragmentSource = ARRAY_FRAGMENT_SOURCE;
+    } else if (textureStorage == TextureStorage::Atlas) {
+        fragmentSource = ATLAS_FRAGMENT_SOURCE;
+    }
+    if (mode == Mode::Instanced) {
+        shader = resourceManager.loadShaderSource(INSTANCED_VERTEX_SOURCE, fragmentSource);
+        vbo.reserve(1024 * sizeof(TexturedBatchRenderer::Instance),
+                    sizeof(TexturedBatchRenderer::Instance));
+    } else {
+        shader = resourceManager.loadShaderSource(VERTEX_SOURCE, fragmentSource);
+        vbo.reserve(1024 * sizeof(TexturedBatchRenderer::Vertex) * VERTICES_PER_QUAD,
+                    sizeof(TexturedBatchRenderer::Vertex));
+    }
     shader->bind();
 
+    setupVertexArray();
+}
+
+void TexturedBatchRenderer::setupVertexArray() {
+    if (mode == Mode::Instanced) {
+        gl::VertexBufferLayout layout;
+        layout.push(GL_FLOAT, 2);        // Position
+        layout.push(GL_FLOAT, 2);        // Scale
+        layout.push(GL_UNSIGNED_INT, 1); // Color
+        layout.push(GL_UNSIGNED_INT, 1); // Texture
+
+        vao.addInstanceBuffer(vbo, layout);
+
+        vao.unbind();
+        vbo.unbind();
+        return;
+    }
+
     vao.bind();
     vbo.bind();
 
@@ -139,25 +259,69 @@ TexturedBatchRenderer::TexturedBatchRenderer(Window& window, res::ResourceManage
     ibo.unbind();
 }
 
-void TexturedBatchRenderer::addTexture(const std::string textureFile, const bool blurred) {
+uint32_t TexturedBatchRenderer::addTexture(const std::string textureFile, const bool blurred) {
+    if (textureStorage == TextureStorage::Atlas) {
+        return addAtlasRegion(resourceManager.loadAtlasTexture(textureFile, blurred));
+    }
+
+    if (textureStorage == TextureStorage::Array) {
+        if (textureArray == nullptr) {
+            textureArray = std::make_unique<gl::Texture2DArray>(blurred);
+        }
+        return textureArray->addLayer(textureFile);
+    }
+
+    if (textures.size() >= MAX_TEXTURE_SLOTS) {
+        throw std::length_error("TexturedBatchRenderer can not have more than "
+                                + std::to_string(MAX_TEXTURE_SLOTS)
+                                + " textures. Use TextureStorage::Array for more textures.");
+    }
     textures.push_back(resourceManager.loadTexture(textureFile, blurred));
+    return static_cast<uint32_t>(textures.size() - 1);
+}
+
+uint32_t TexturedBatchRenderer::addAtlasRegion(const res::AtlasRegionHandle& region) {
+    if (textureStorage != TextureStorage::Atlas) {
+        throw std::logic_error("Atlas regions require TextureStorage::Atlas");
+    }
+
+    if (atlas == nullptr) {
+        atlas = region->atlas;
+    } else if (region->atlas != atlas) {
+        throw std::invalid_argument(
+            "All atlas regions of a TexturedBatchRenderer must come from the same atlas");
+    }
+
+    return region->index;
 }
 
 void TexturedBatchRenderer::clearElements() {
     vertices.clear();
+    instances.clear();
 }
 
 void TexturedBatchRenderer::reserve(const size_t count) {
+    if (mode == Mode::Instanced) {
+        instances.reserve(count);
+        if (vbo.reserve(count * sizeof(TexturedBatchRenderer::Instance),
+                        sizeof(TexturedBatchRenderer::Instance))) {
+            setupVertexArray();
+        }
+        return;
+    }
+
     vertices.reserve(count * VERTICES_PER_QUAD);
     createIndicesForQuads(count);
 
-    vbo.setData(nullptr, count * sizeof(TexturedBatchRenderer::Vertex) * VERTICES_PER_QUAD,
-                GL_STREAM_DRAW);
+    if (vbo.reserve(count * sizeof(TexturedBatchRenderer::Vertex) * VERTICES_PER_QUAD,
+                    sizeof(TexturedBatchRenderer::Vertex))) {
+        setupVertexArray();
+    }
 }
 
 void TexturedBatchRenderer::draw(const Window& window) {
-    vbo.setData(vertices.data(), vertices.size() * sizeof(TexturedBatchRenderer::Vertex),
-                GL_STREAM_DRAW);
+    if (vertices.empty() && instances.empty())
+        return;
 
     shader->bind();
 
@@ -170,28 +334,81 @@ void TexturedBatchRenderer::draw(const Window& window) {
 
     glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0));
 
-    std::vector<GLint> samplers;
-    samplers.reserve(textures.size());
-    for (size_t i = 0; i < textures.size(); i++) {
-        samplers.push_back(static_cast<GLuint>(i));
-    }
-    shader->setUniformSamplers("u_Textures", static_cast<GLsizei>(textures.size()),
-                               samplers.data());
-
-    for (size_t i = 0; i < textures.size(); i++) {
-        textures[i]->bind(i);
+    if (textureStorage == TextureStorage::Atlas) {
+        shader->setUniform1i("u_TextureArray", 0);
+        if (atlas != nullptr) {
+            // Regions may have been added to the atlas by others since the last draw
+            atlas->bindRegions(0);
+            atlas->texture().bind(0);
+        }
+    } else if (textureStorage == TextureStorage::Array) {
+        shader->setUniform1i("u_TextureArray", 0);
+        if (textureArray != nullptr) {
+            textureArray->bind(0);
+        }
+    } else {
+        std::vector<GLint> samplers;
+        samplers.reserve(textures.size());
+        for (size_t i = 0; i < textures.size(); i++) {
+            samplers.push_back(static_cast<GLuint>(i));
+        }
+        shader->setUniformSamplers("u_Textures", static_cast<GLsizei>(textures.size()),
+                                   samplers.data());
+
+        for (size_t i = 0; i < textures.size(); i++) {
+            textures[i]->bind(i);
+        }
     }
 
     shader->setUniformMat4f("u_ViewProj", projection);
     shader->setUniformMat4f("u_Transform", view);
 
+    if (mode == Mode::Instanced) {
+        drawInstances();
+    } else {
+        drawVertices();
+    }
+}
+
+void TexturedBatchRenderer::drawVertices() {
+    const size_t quadCount = vertices.size() / VERTICES_PER_QUAD;
+    createIndicesForQuads(quadCount);
+
+    const GLsizeiptr vertexBytes = vertices.size() * sizeof(TexturedBatchRenderer::Vertex);
+    if (vbo.reserve(vertexBytes, sizeof(TexturedBatchRenderer::Vertex))) {
+        setupVertexArray();
+    }
+    const GLintptr vertexOffset
+        = vbo.write(vertices.data(), vertexBytes, sizeof(TexturedBatchRenderer::Vertex));
+
     vao.bind();
     ibo.bind();
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+    glDrawElementsBaseVertex(
+        GL_TRIANGLES, static_cast<GLsizei>(quadCount * INDICES_PER_QUAD), GL_UNSIGNED_INT, nullptr,
+        static_cast<GLint>(vertexOffset / sizeof(TexturedBatchRenderer::Vertex)));
+}
+
+void TexturedBatchRenderer::drawInstances() {
+    const GLsizeiptr instanceBytes = instances.size() * sizeof(TexturedBatchRenderer::Instance);
+    if (vbo.reserve(instanceBytes, sizeof(TexturedBatchRenderer::Instance))) {
+        setupVertexArray();
+    }
+    const GLintptr instanceOffset
+        = vbo.write(instances.data(), instanceBytes, sizeof(TexturedBatchRenderer::Instance));
+
+    vao.bind();
+    glDrawArraysInstancedBaseInstance(
+        GL_TRIANGLE_STRIP, 0, VERTICES_PER_QUAD, static_cast<GLsizei>(instances.size()),
+        static_cast<GLuint>(instanceOffset / sizeof(TexturedBatchRenderer::Instance)));
 }
 
 void TexturedBatchRenderer::addQuad(const glm::vec2 position, const glm::vec2 scale,
                                     const glm::vec4 color, const uint32_t textureIndex) {
+    if (mode == Mode::Instanced) {
+        instances.push_back({position, scale, packColor(color), textureIndex});
+        return;
+    }
+
     std::array<TexturedBatchRenderer::Vertex, 4> quad
         = createQuad(position, scale, color, textureIndex);
     vertices.push_back(quad[0]);
@@ -1,51 +1,102 @@
 #pragma once
 #include "Window.h"
 #include "gl/IndexBuffer.h"
+#include "gl/StreamBuffer.h"
+#include "gl/Texture2DArray.h"
 #include "gl/VertexArray.h"
 #include "gl/VertexBufferLayout.h"
 #include "res/ResourceManager.h"
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace fc {
 
 class TexturedBatchRenderer {
+public:
+    enum class Mode : uint8_t {
+        // Every quad is expanded into 4 vertices and 6 indices on the CPU
+        Vertices,
+        // Every quad is a single instance, expanded into a unit quad by the vertex shader
+        Instanced
+    };
+
+    enum class TextureStorage : uint8_t {
+        // Every texture is bound to its own texture unit, which limits a batch to 16 textures
+        Slots,
+        // Every texture is a layer of a single texture array. All textures must have the same
+        // size, but a batch can reference thousands of them.
+        Array,
+        // Every texture is a region of a res::TextureAtlas. Textures can have any size that fits
+        // on an atlas page, and a batch can reference any number of them.
+        Atlas
+    };
+
 private:
     struct Vertex {
         glm::vec2 position;
         GLuint RGBA;
+        // The lowest 2 bits are the corner of the quad, the other 30 bits are the texture
         GLuint texIDTexCoordIndex;
     };
 
+    struct Instance {
+        glm::vec2 position;
+        glm::vec2 scale;
+        GLuint RGBA;
+        GLuint texID;
+    };
+
 private:
     const uint32_t INDICES_PER_QUAD = 6;
     const uint32_t VERTICES_PER_QUAD = 4;
+    const uint32_t MAX_TEXTURE_SLOTS = 16;
 
 private:
+    Mode mode;
+    TextureStorage textureStorage;
+
     std::vector<TexturedBatchRenderer::Vertex> vertices;
+    std::vector<TexturedBatchRenderer::Instance> instances;
     res::ResourceManager& resourceManager;
 
     glm::mat4 m_View;
     glm::mat4 m_Projection;
 
     std::vector<res::TextureHandle> textures;
+    std::unique_ptr<gl::Texture2DArray> textureArray;
+    res::TextureAtlas* atlas = nullptr;
     std::vector<GLuint> indices;
     gl::IndexBuffer ibo;
-    gl::VertexBuffer vbo;
+    gl::StreamVertexBuffer vbo;
     gl::VertexArray vao;
     res::ShaderHandle shader;
 
 private:
     void createIndicesForQuads(size_t quadCount);
+    void setupVertexArray();
     std::array<TexturedBatchRenderer::Vertex, 4> createQuad(const glm::vec2 position,
                                                             const glm::vec2 scale,
                                                             const glm::vec4 color,
                                                             const uint32_t textureID);
+    static GLuint packColor(const glm::vec4 color);
+
+    void drawVertices();
+    void drawInstances();
 
 public:
-    TexturedBatchRenderer(Window& window, res::ResourceManager& resourceManager);
-    void addTexture(const std::string textureFile, const bool blurred);
+    TexturedBatchRenderer(Window& window, res::ResourceManager& resourceManager,
+                          Mode mode = Mode::Vertices,
+                          TextureStorage textureStorage = TextureStorage::Slots);
+    // Returns the texture index to use with addQuad. With TextureStorage::Array, the first
+    // texture decides the filtering of all textures. With TextureStorage::Array and Atlas, the
+    // file is decoded at once, even while a ResourceManager::loadTextureAsync of it is running,
+    // since the pixels are copied and the async placeholder would never be replaced.
+    uint32_t addTexture(const std::string textureFile, const bool blurred);
+    // Returns the texture index to use with addQuad. Only valid with TextureStorage::Atlas, and
+    // all regions must come from the same atlas.
+    uint32_t addAtlasRegion(const res::AtlasRegionHandle& region);
     void clearElements();
     void draw(const Window& window);
     void reserve(const size_t count);
@@ -1,5 +1,7 @@
 #pragma once
 #include "Container.h"
+#include <algorithm>
+#include <vector>
 
 namespace fc {
 class VerticalPositioning : public Container {
@@ -18,17 +20,16 @@ public:
     VerticalPositioning(alignment::ElementAlignment alignment)
         : VerticalPositioning(alignment, Direction::TopToBottom) {}
 
-    void setSpacing(float spacing) { spacing = spacing; }
+    void setSpacing(float spacing) {
+        this->spacing = spacing;
+        invalidateLayout();
+        markDirty();
+    }
 
     void childCreated(fiv::ID id) override {
         children()[id]->alignment.y
             = alignment::AlignmentFunction([id, this](float parent1, float parent2) -> float {
-                  float yOffset = 0.0f;
-                  auto index = children().indexOf(id);
-                  for (size_t i = 0; i < index; i++) {
-                      float childHeight = children().dataAt(i)->getPixelSize().y;
-                      yOffset += childHeight + (childHeight > 0 ? spacing : 0);
-                  }
+                  const float yOffset = childOffset(children().indexOf(id));
 
                   if (direction == Direction::BottomToTop) {
                       return yOffset;
@@ -37,5 +38,57 @@ public:
                   }
               });
     }
+
+protected:
+    // The distance from the start of the container to the child at the given index
+    float childOffset(size_t index) const {
+        updateOffsets();
+        return _offsets[index];
+    }
+
+    // The total height of the children, including spacing
+    float contentLength() const {
+        updateOffsets();
+        return _offsets.back();
+    }
+
+    // The range [first, last) of children that overlap the given distances from the start of
+    // the container. Found with a binary search over the cached offsets, which requires every
+    // child but the first to have a non-negative height.
+    std::pair<size_t, size_t> childrenInRange(float start, float end) const {
+        updateOffsets();
+        // The searches below need at least one child to form valid ranges
+        if (_offsets.size() < 2)
+            return {0, 0};
+
+        // _offsets[i + 1] is where child i ends (plus spacing)
+        const auto firstEnd = std::upper_bound(_offsets.begin() + 1, _offsets.end(), start);
+        const auto lastStart = std::lower_bound(_offsets.begin() + 1, _offsets.end() - 1, end);
+        const size_t first = firstEnd - (_offsets.begin() + 1);
+        const size_t last = lastStart - _offsets.begin();
+        return {first, std::max(first, last)};
+    }
+
+private:
+    void updateOffsets() const {
+        if (_offsetsGeneration == layoutGeneration() && _offsets.size() == children().size() + 1)
+            return;
+
+        // Prefix sum of the child heights, computed once per layout. The last entry is the
+        // total height.
+        _offsets.resize(children().size() + 1);
+        float yOffset = 0.0f;
+        for (size_t i = 0; i < children().size(); i++) {
+            _offsets[i] = yOffset;
+            const float childHeight = children().dataAt(i)->getPixelSize().y;
+            yOffset += childHeight + (childHeight > 0 ? spacing : 0);
+        }
+        _offsets.back() = yOffset;
+        _offsetsGeneration = layoutGeneration();
+    }
+
+private:
+    mutable std::vector<float> _offsets;
+    mutable uint64_t _offsetsGeneration = 0;
 };
 } // namespace fc
\ No newline at end of file
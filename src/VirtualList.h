@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Container.h"
+#include "ShapeRenderer2D.h"
+#include "core/Maths.h"
+#include "gl/RenderRegion.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace fc {
+
+// A scrollable list of rows that all have the same height. Only enough row elements to fill
+// the visible area are created, and they are reused as the list scrolls: whenever a row
+// element is moved to another row, the bind function is called to fill it with the data of
+// that row. Since the rows have the same height, the visible rows are found directly from the
+// scroll offset, and the cost of a frame does not depend on the number of rows.
+class VirtualList : public Container {
+public:
+    // Creates a row element, as a child of the list
+    using RowFactory = std::function<Element&(VirtualList& list)>;
+    // Fills a row element with the data of the row at the given index
+    using RowBinder = std::function<void(Element& row, size_t index)>;
+
+private:
+    // The distance from the top of the list to the top of the visible area. A double, so that
+    // rows stay in place far down long lists.
+    double _scrollOffset = 0.0;
+    float _rowHeight;
+    size_t _rowCount = 0;
+
+    RowFactory _createRow;
+    RowBinder _bindRow;
+    ShapeRenderer2D& _renderer;
+
+    // The row each row element is bound to. The n:th visible row uses the n:th element.
+    std::vector<size_t> _boundRows;
+    // The number of row elements used this frame
+    size_t _activeRows = 0;
+    // The scroll offset and height the row elements were last placed for
+    double _placedOffset = -1.0;
+    float _placedHeight = -1.0f;
+
+    static constexpr size_t UNBOUND = std::numeric_limits<size_t>::max();
+
+public:
+    float scrollSpeed = 40.0f;
+
+public:
+    VirtualList(alignment::ElementAlignment alignment, ShapeRenderer2D& renderer, float rowHeight,
+                RowFactory createRow, RowBinder bindRow)
+        : Container(alignment),
+          _rowHeight(rowHeight),
+          _createRow(std::move(createRow)),
+          _bindRow(std::move(bindRow)),
+          _renderer(renderer) {}
+
+    virtual void render(const Window& window, time::Duration delta) override {
+        gl::RenderRegion::push(getPixelRectangle(), gl::RenderRegion::Mode::Scissor);
+
+        const glm::vec2 elSize = getPixelSize();
+        const glm::vec2 elPos = getPixelPosition();
+
+        _scrollOffset = std::clamp(_scrollOffset, 0.0, maxScrollOffset());
+        layoutRows();
+
+        Container::render(window, delta);
+
+        // Draw the scrollbar
+        const float totalHeight = static_cast<float>(contentHeight());
+        if (totalHeight > elSize.y) {
+            const float width = 6.0f;
+            const float padding = 2.0f;
+            const float visualHeight = elSize.y - padding / 2;
+
+            const float height
+                = std::clamp(visualHeight * (visualHeight / totalHeight), 30.0f, visualHeight);
+            const float y
+                = maths::map(static_cast<float>(_scrollOffset / maxScrollOffset()), 1.0f, 0.0f,
+                             0.0f, visualHeight - height);
+            _renderer.roundedRect(window, elPos + glm::vec2(elSize.x - width - padding, y),
+                                  {width, height}, {0.5, 0.5, 0.5, 0.75}, width * 0.5f, 12);
+        }
+
+        gl::RenderRegion::pop();
+    }
+
+    // Positive brings the content downwards, negative brings it upwards
+    void scroll(float pixels) {
+        _scrollOffset = std::clamp(_scrollOffset - pixels * scrollSpeed, 0.0, maxScrollOffset());
+        invalidateLayout();
+        markDirty();
+    }
+
+    virtual void onScroll(Input& input, input::ScrollEvent event) override {
+        scroll(event.offset.y);
+    }
+
+    void setRowCount(size_t rowCount) {
+        _rowCount = rowCount;
+        // The rows may show other data now
+        std::fill(_boundRows.begin(), _boundRows.end(), UNBOUND);
+        markDirty();
+    }
+
+    // Makes every row element fetch its data again
+    void refresh() {
+        std::fill(_boundRows.begin(), _boundRows.end(), UNBOUND);
+        markDirty();
+    }
+
+    void scrollToRow(size_t row) {
+        _scrollOffset = std::clamp(row * static_cast<double>(_rowHeight), 0.0, maxScrollOffset());
+        invalidateLayout();
+        markDirty();
+    }
+
+    size_t rowCount() const { return _rowCount; }
+    float rowHeight() const { return _rowHeight; }
+    double contentHeight() const { return _rowCount * static_cast<double>(_rowHeight); }
+    double getScrollOffset() const { return _scrollOffset; }
+
+protected:
+    // Only the row elements in use are rendered and hit-tested
+    virtual std::pair<size_t, size_t> visibleChildRange() const override {
+        return {0, _activeRows};
+    }
+
+private:
+    double maxScrollOffset() const { return std::max(0.0, contentHeight() - getPixelSize().y); }
+
+    // Moves the row elements to the rows in view, creating more elements if needed
+    void layoutRows() {
+        const float height = getPixelSize().y;
+        const size_t firstRow = static_cast<size_t>(_scrollOffset / _rowHeight);
+        const size_t visibleRows = static_cast<size_t>(std::ceil(height / _rowHeight)) + 1;
+        const size_t activeRows = std::min(visibleRows, _rowCount - std::min(firstRow, _rowCount));
+        // The rows only move when one of these changes, or a row element is bound to another row
+        bool changed = activeRows != _activeRows || _scrollOffset != _placedOffset
+                       || height != _placedHeight;
+        _activeRows = activeRows;
+
+        while (_boundRows.size() < _activeRows) {
+            _createRow(*this);
+            _boundRows.push_back(UNBOUND);
+        }
+
+        for (size_t i = 0; i < _activeRows; i++) {
+            const size_t row = firstRow + i;
+            Element& element = *children().dataAt(i);
+
+            if (_boundRows[i] != row) {
+                _bindRow(element, row);
+                _boundRows[i] = row;
+                changed = true;
+            }
+
+            const float top
+                = static_cast<float>(row * static_cast<double>(_rowHeight) - _scrollOffset);
+            element.alignment.setY(alignment::Pixels(height - top - _rowHeight));
+            element.alignment.setHeight(alignment::Pixels(_rowHeight));
+        }
+
+        // Invalidating the layout makes every element rendered after the list compute its
+        // rectangle again, so it is only done when the rows moved
+        if (changed) {
+            _placedOffset = _scrollOffset;
+            _placedHeight = height;
+            invalidateLayout();
+        }
+    }
+};
+} // namespace fc
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Window.h"
 #include "gl/OpenGL.h"
 #include "gl/RenderRegion.h"
+#include "gl/State.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include <iostream>
 
@@ -83,16 +84,17 @@ Window::Window(WindowProperties& properties) {
     glfwSetWindowSizeCallback(_handle, sizeCallback);
     glfwSetWindowIconifyCallback(_handle, iconifyCallback);
     glfwSetWindowMaximizeCallback(_handle, maximizeCallback);
+    glfwSetWindowRefreshCallback(_handle, refreshCallback);
 
     if (properties.antialiasing) {
-        glEnable(GL_MULTISAMPLE);
+        gl::State::enable(GL_MULTISAMPLE);
     }
 #ifdef _DEBUG
     int flags;
     glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
     if (flags & GL_CONTEXT_FLAG_DEBUG_BIT) {
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        gl::State::enable(GL_DEBUG_OUTPUT);
+        gl::State::enable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
         glDebugMessageCallback(debugOutput, NULL);
     }
 #endif // _DEBUG
@@ -111,6 +113,17 @@ void Window::display() {
     glfwPollEvents();
 }
 
+void Window::waitEvents(double timeoutSeconds) {
+    _input.update();
+    glfwWaitEventsTimeout(timeoutSeconds);
+}
+
+bool Window::isContentLost() {
+    const bool lost = _contentLost;
+    _contentLost = false;
+    return lost;
+}
+
 bool Window::shouldClose() const {
     return glfwWindowShouldClose(_handle);
 }
@@ -173,6 +186,7 @@ void Window::resized() {
     glm::ivec2 dim = dimensions();
     gl::RenderRegion::base = {0.0f, 0.0f, static_cast<float>(dim.x), static_cast<float>(dim.y)};
     gl::RenderRegion::applyBase();
+    _contentLost = true;
 }
 
 void Window::sizeCallback(GLFWwindow* window, int width, int height) {
@@ -193,6 +207,11 @@ void Window::iconifyCallback(int iconified) {
     resized();
 }
 
+void Window::refreshCallback(GLFWwindow* window) {
+    Window* windowObj = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    windowObj->_contentLost = true;
+}
+
 void Window::maximizeCallback(GLFWwindow* window, int maximized) {
     Window* windowObj = static_cast<Window*>(glfwGetWindowUserPointer(window));
     windowObj->maximizeCallback(maximized);
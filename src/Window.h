@@ -31,6 +31,7 @@ private:
     GLFWwindow* _handle;
     Input _input;
     glm::vec4 _clearColor;
+    bool _contentLost = true;
 
 public:
     Window(WindowProperties& properties);
@@ -40,7 +41,13 @@ public:
     Window& operator=(const Window& window) = delete;
 
     void display();
+    // Handles input like display() does, without presenting a new frame. Waits up to the given
+    // number of seconds for an event to arrive, so that idle applications do not spin.
+    void waitEvents(double timeoutSeconds);
     bool shouldClose() const;
+    // Whether the window was resized or its content damaged since the last call, in which case
+    // the next frame must be rendered even if nothing else changed
+    bool isContentLost();
     void setTitle(const std::string& title);
 
     void lockMouse();
@@ -71,6 +78,8 @@ private:
 
     static void maximizeCallback(GLFWwindow* window, int maximized);
     void maximizeCallback(int maximized);
+
+    static void refreshCallback(GLFWwindow* window);
 };
 
 } // namespace fc
\ No newline at end of file
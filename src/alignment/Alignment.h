@@ -1,13 +1,197 @@
 #pragma once
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
 #include <functional>
+#include <memory>
 
 namespace fc::alignment {
+// The parameter is the same as that of AlignmentFunction
+using ConditionalFunc = std::function<bool(float, float)>;
+
 // A function used to calculate the child's position or size based on the
 // parent's width or height The arguments are the parent's width and height in
 // the following order: if the alignment is used as x position or width:
 //  - parent width, parent height
 // if the alignment is used as y position or height:
 //  - parent height, parent width
-using AlignmentFunction = std::function<float(float, float)>;
+//
+// An AlignmentFunction is a small expression tree. The leaves (Pixels, Relative and
+// combinations of them) are stored inline as a * parent1 + b * parent2 + pixels, and are
+// folded together where possible, so the common alignments evaluate as plain arithmetic
+// without any indirect calls. Copying only copies the leaf or bumps a reference count.
+// Any callable taking (float, float) converts to an AlignmentFunction, for alignments that
+// can not be expressed otherwise.
+class AlignmentFunction {
+public:
+    enum class Kind : uint8_t {
+        Linear,
+        Max,
+        Min,
+        Add,
+        Subtract,
+        SwapRef,
+        Conditional,
+        // Evaluates another AlignmentFunction, which may change after this one is created
+        Reference,
+        Function
+    };
+
+private:
+    struct Node {
+        std::shared_ptr<const AlignmentFunction> first;
+        std::shared_ptr<const AlignmentFunction> second;
+        ConditionalFunc condition;
+        const AlignmentFunction* reference = nullptr;
+        std::function<float(float, float)> function;
+    };
+
+    Kind m_Kind = Kind::Linear;
+    float m_Parent1 = 0.0f;
+    float m_Parent2 = 0.0f;
+    float m_Pixels = 0.0f;
+    std::shared_ptr<const Node> m_Node;
+
+public:
+    // Zero pixels
+    AlignmentFunction() = default;
+
+    template <typename F>
+        requires(!std::same_as<std::decay_t<F>, AlignmentFunction>
+                 && std::is_invocable_r_v<float, F&, float, float>)
+    AlignmentFunction(F&& function) : m_Kind(Kind::Function) {
+        auto node = std::make_shared<Node>();
+        node->function = std::forward<F>(function);
+        m_Node = std::move(node);
+    }
+
+    float operator()(float parent1, float parent2) const {
+        switch (m_Kind) {
+        case Kind::Linear:
+            return m_Parent1 * parent1 + m_Parent2 * parent2 + m_Pixels;
+        case Kind::Max:
+            return std::max((*m_Node->first)(parent1, parent2),
+                            (*m_Node->second)(parent1, parent2));
+        case Kind::Min:
+            return std::min((*m_Node->first)(parent1, parent2),
+                            (*m_Node->second)(parent1, parent2));
+        case Kind::Add:
+            return (*m_Node->first)(parent1, parent2) + (*m_Node->second)(parent1, parent2);
+        case Kind::Subtract:
+            return (*m_Node->first)(parent1, parent2) - (*m_Node->second)(parent1, parent2);
+        case Kind::SwapRef:
+            return (*m_Node->first)(parent2, parent1);
+        case Kind::Conditional:
+            if (m_Node->condition(parent1, parent2)) {
+                return (*m_Node->first)(parent1, parent2);
+            } else {
+                return (*m_Node->second)(parent1, parent2);
+            }
+        case Kind::Reference:
+            return (*m_Node->reference)(parent1, parent2);
+        case Kind::Function:
+            return m_Node->function(parent1, parent2);
+        }
+        // Should not reach this return
+        return 0.0f;
+    }
+
+    inline Kind kind() const { return m_Kind; }
+
+    // parent1 * parent1Coefficient + parent2 * parent2Coefficient + pixels
+    static AlignmentFunction linear(float parent1Coefficient, float parent2Coefficient,
+                                    float pixels) {
+        AlignmentFunction result;
+        result.m_Parent1 = parent1Coefficient;
+        result.m_Parent2 = parent2Coefficient;
+        result.m_Pixels = pixels;
+        return result;
+    }
+
+    static AlignmentFunction max(const AlignmentFunction& a, const AlignmentFunction& b) {
+        if (a.isConstant() && b.isConstant())
+            return linear(0.0f, 0.0f, std::max(a.m_Pixels, b.m_Pixels));
+        return binary(Kind::Max, a, b);
+    }
+
+    static AlignmentFunction min(const AlignmentFunction& a, const AlignmentFunction& b) {
+        if (a.isConstant() && b.isConstant())
+            return linear(0.0f, 0.0f, std::min(a.m_Pixels, b.m_Pixels));
+        return binary(Kind::Min, a, b);
+    }
+
+    static AlignmentFunction add(const AlignmentFunction& a, const AlignmentFunction& b) {
+        if (a.m_Kind == Kind::Linear && b.m_Kind == Kind::Linear)
+            return linear(a.m_Parent1 + b.m_Parent1, a.m_Parent2 + b.m_Parent2,
+                          a.m_Pixels + b.m_Pixels);
+        return binary(Kind::Add, a, b);
+    }
+
+    static AlignmentFunction subtract(const AlignmentFunction& a, const AlignmentFunction& b) {
+        if (a.m_Kind == Kind::Linear && b.m_Kind == Kind::Linear)
+            return linear(a.m_Parent1 - b.m_Parent1, a.m_Parent2 - b.m_Parent2,
+                          a.m_Pixels - b.m_Pixels);
+        return binary(Kind::Subtract, a, b);
+    }
+
+    static AlignmentFunction swapRef(const AlignmentFunction& function) {
+        if (function.m_Kind == Kind::Linear)
+            return linear(function.m_Parent2, function.m_Parent1, function.m_Pixels);
+
+        AlignmentFunction result;
+        result.m_Kind = Kind::SwapRef;
+        auto node = std::make_shared<Node>();
+        node->first = std::make_shared<const AlignmentFunction>(function);
+        result.m_Node = std::move(node);
+        return result;
+    }
+
+    static AlignmentFunction conditional(ConditionalFunc condition,
+                                         const AlignmentFunction& ifTrue,
+                                         const AlignmentFunction& ifFalse) {
+        AlignmentFunction result;
+        result.m_Kind = Kind::Conditional;
+        auto node = std::make_shared<Node>();
+        node->first = std::make_shared<const AlignmentFunction>(ifTrue);
+        node->second = std::make_shared<const AlignmentFunction>(ifFalse);
+        node->condition = std::move(condition);
+        result.m_Node = std::move(node);
+        return result;
+    }
+
+    // The referenced function must outlive the returned one
+    static AlignmentFunction reference(const AlignmentFunction& function) {
+        AlignmentFunction result;
+        result.m_Kind = Kind::Reference;
+        auto node = std::make_shared<Node>();
+        node->reference = &function;
+        result.m_Node = std::move(node);
+        return result;
+    }
+
+private:
+    inline bool isConstant() const {
+        return m_Kind == Kind::Linear && m_Parent1 == 0.0f && m_Parent2 == 0.0f;
+    }
+
+    static AlignmentFunction binary(Kind kind, const AlignmentFunction& a,
+                                    const AlignmentFunction& b) {
+        AlignmentFunction result;
+        result.m_Kind = kind;
+        auto node = std::make_shared<Node>();
+        node->first = std::make_shared<const AlignmentFunction>(a);
+        node->second = std::make_shared<const AlignmentFunction>(b);
+        result.m_Node = std::move(node);
+        return result;
+    }
+};
+
+inline AlignmentFunction operator+(const AlignmentFunction& a, const AlignmentFunction& b) {
+    return AlignmentFunction::add(a, b);
+}
+
+inline AlignmentFunction operator-(const AlignmentFunction& a, const AlignmentFunction& b) {
+    return AlignmentFunction::subtract(a, b);
+}
 
-} // namespace fc::alignment
+} // namespace fc::alignment
\ No newline at end of file
@@ -4,8 +4,6 @@
 
 namespace fc::alignment {
 static AlignmentFunction MirrorHeight(const Element& element) {
-    return [&element](float parent1, float parent2) {
-        return element.alignment.height(parent1, parent2);
-    };
+    return AlignmentFunction::reference(element.alignment.height);
 }
 } // namespace fc::alignment
\ No newline at end of file
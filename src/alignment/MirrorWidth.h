@@ -4,8 +4,6 @@
 
 namespace fc::alignment {
 static AlignmentFunction MirrorWidth(const Element& element) {
-    return [&element](float parent1, float parent2) {
-        return element.alignment.width(parent1, parent2);
-    };
+    return AlignmentFunction::reference(element.alignment.width);
 }
 } // namespace fc::alignment
\ No newline at end of file
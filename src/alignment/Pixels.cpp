@@ -1,5 +1,5 @@
 #include "Pixels.h"
 
 fc::alignment::AlignmentFunction fc::alignment::Pixels(float pixels) {
-    return [pixels](float parent1, float parent2) -> float { return pixels; };
+    return AlignmentFunction::linear(0.0f, 0.0f, pixels);
 }
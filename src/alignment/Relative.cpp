@@ -1,5 +1,5 @@
 #include "Relative.h"
 
 fc::alignment::AlignmentFunction fc::alignment::Relative(float coefficient) {
-    return [coefficient](float parent1, float parent2) -> float { return coefficient * parent1; };
+    return AlignmentFunction::linear(coefficient, 0.0f, 0.0f);
 }
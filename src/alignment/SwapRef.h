@@ -3,6 +3,6 @@
 
 namespace fc::alignment {
 inline AlignmentFunction SwapRef(AlignmentFunction function) {
-    return [function](float parent1, float parent2) { return function(parent2, parent1); };
+    return AlignmentFunction::swapRef(function);
 }
 } // namespace fc::alignment
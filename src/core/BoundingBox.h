@@ -0,0 +1,55 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include <limits>
+
+namespace fc {
+
+// An axis-aligned bounding box. A default constructed box is empty, and grows to contain what
+// is added to it.
+struct BoundingBox {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    BoundingBox() = default;
+    BoundingBox(const glm::vec3& min, const glm::vec3& max) : min(min), max(max) {}
+
+    bool empty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    void add(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void add(const BoundingBox& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 size() const { return max - min; }
+
+    // The box containing this box after it is transformed, which may be larger than the
+    // transformed box itself
+    BoundingBox transformed(const glm::mat4& transform) const {
+        if (empty())
+            return *this;
+
+        // For every axis, the smallest and largest contribution of each input axis is summed
+        const glm::vec3 translation(transform[3]);
+        BoundingBox result(translation, translation);
+        for (int column = 0; column < 3; column++) {
+            const glm::vec3 axis(transform[column]);
+            const glm::vec3 a = axis * min[column];
+            const glm::vec3 b = axis * max[column];
+            result.min += glm::min(a, b);
+            result.max += glm::max(a, b);
+        }
+        return result;
+    }
+
+    bool operator==(const BoundingBox& other) const {
+        return min == other.min && max == other.max;
+    }
+};
+} // namespace fc
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "BoundingBox.h"
+#include "glm/glm.hpp"
+#include <array>
+
+namespace fc {
+
+// The six planes enclosing what a camera sees, with their normals pointing inwards
+struct Frustum {
+    // xyz is the normal and w the distance, so that dot(normal, point) + w >= 0 inside
+    std::array<glm::vec4, 6> planes;
+
+    // The frustum of the combined projection and view matrix
+    explicit Frustum(const glm::mat4& viewProjection) {
+        const glm::mat4 m = glm::transpose(viewProjection);
+        planes[0] = m[3] + m[0]; // left
+        planes[1] = m[3] - m[0]; // right
+        planes[2] = m[3] + m[1]; // bottom
+        planes[3] = m[3] - m[1]; // top
+        planes[4] = m[3] + m[2]; // near
+        planes[5] = m[3] - m[2]; // far
+    }
+
+    // Whether any part of the box may be inside. Boxes near the corners of the frustum may be
+    // reported to intersect it when they do not.
+    bool intersects(const BoundingBox& box) const {
+        if (box.empty())
+            return false;
+
+        for (const glm::vec4& plane : planes) {
+            // The corner of the box furthest along the normal
+            const glm::vec3 corner(plane.x >= 0.0f ? box.max.x : box.min.x,
+                                   plane.y >= 0.0f ? box.max.y : box.min.y,
+                                   plane.z >= 0.0f ? box.max.z : box.min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+} // namespace fc
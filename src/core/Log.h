@@ -0,0 +1,24 @@
+#pragma once
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+namespace fc {
+
+inline std::mutex& logMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Writes the values to std::cout as one line. Lines logged by several threads at once are
+// written one after the other instead of mixed together.
+template <typename... Values> void logLine(const Values&... values) {
+    std::ostringstream line;
+    (line << ... << values);
+    line << '\n';
+
+    std::lock_guard lock(logMutex());
+    std::cout << line.str() << std::flush;
+}
+
+} // namespace fc
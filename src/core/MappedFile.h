@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace fc {
+
+// A file mapped read-only into memory, so that it can be read without copying it first
+class MappedFile {
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _open = false;
+
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // move assignment
+    MappedFile& operator=(MappedFile&& other);
+    // move constructor
+    MappedFile(MappedFile&& other);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Whether the file could be opened. An empty file is open, but has no data.
+    bool isOpen() const { return _open; }
+
+    std::string_view view() const { return {_data, _size}; }
+    size_t size() const { return _size; }
+
+private:
+    void close();
+};
+} // namespace fc
@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fc::parallel {
+
+namespace detail {
+inline thread_local bool serial = false;
+}
+
+// Makes forEach run serially when it is called from this thread. ThreadPool calls it on its
+// threads, whose jobs already keep the cores busy, so that each job does not start a thread
+// per core of its own.
+inline void runSeriallyOnThisThread() {
+    detail::serial = true;
+}
+
+// The number of threads worth running at once, at least one
+inline size_t workerCount() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Calls function(i) for every i in [0, count), spread over up to workerCount() threads. The
+// calling thread is one of them, and the only one after runSeriallyOnThisThread(). Returns once
+// every call has returned. If a call throws, the remaining indices are skipped and the first
+// exception is rethrown.
+template <typename F> void forEach(size_t count, F&& function) {
+    const size_t threadCount = detail::serial ? 1 : std::min(count, workerCount());
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            function(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next = 0;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                function(i);
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 0; i + 1 < threadCount; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace fc::parallel
@@ -0,0 +1,51 @@
+#include "ThreadPool.h"
+#include "Parallel.h"
+#include <utility>
+
+namespace fc {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    for (size_t i = 0; i < threadCount; i++) {
+        _threads.emplace_back([this]() { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+        _jobs.clear();
+    }
+    _jobAdded.notify_all();
+
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _jobAdded.notify_one();
+}
+
+void ThreadPool::work() {
+    parallel::runSeriallyOnThisThread();
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(_mutex);
+            _jobAdded.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+            if (_stopping)
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace fc
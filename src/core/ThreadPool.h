@@ -0,0 +1,39 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fc {
+
+// A fixed set of threads that run jobs in the order they were submitted. Jobs must not throw.
+// When the pool is destroyed, the running jobs are waited for and the ones that have not
+// started are dropped. Jobs that call parallel::forEach run it serially, since the other threads
+// of the pool are busy with jobs of their own.
+class ThreadPool {
+private:
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _jobAdded;
+    bool _stopping = false;
+
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job);
+
+    size_t threadCount() const { return _threads.size(); }
+
+private:
+    void work();
+};
+
+} // namespace fc
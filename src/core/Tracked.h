@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <functional>
+
 namespace fc {
 
 /// @brief A wrapper around a value that tracks whether it has been modified.
@@ -8,6 +10,7 @@ template <typename T> class Tracked {
 private:
     T _currentValue{};
     bool _hasChanged{false};
+    std::function<void()> _onModified;
 
 public:
     // Default constructor
@@ -23,6 +26,8 @@ public:
     Tracked& operator=(const T& newVal) {
         _hasChanged = (newVal != _currentValue);
         _currentValue = newVal;
+        if (_hasChanged && _onModified)
+            _onModified();
         return *this;
     }
 
@@ -42,7 +47,15 @@ public:
     }
 
     /// @brief Manually mark the value as modified.
-    void markModified() { _hasChanged = true; }
+    void markModified() {
+        _hasChanged = true;
+        if (_onModified)
+            _onModified();
+    }
+
+    /// @brief Sets a function to call every time the value is modified, for owners that
+    /// need to react right away rather than on the next call to `isModified`.
+    void onModified(std::function<void()> callback) { _onModified = std::move(callback); }
 };
 
 } // namespace fc
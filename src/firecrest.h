@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Button.h"
+#include "CachedLayer.h"
 #include "Camera.h"
 #include "ColoredBatchRenderer.h"
 #include "ColoredRect.h"
@@ -29,6 +30,7 @@
 #include "VerticalCenterer.h"
 #include "VerticalContainer.h"
 #include "VerticalPositioning.h"
+#include "VirtualList.h"
 #include "Window.h"
 #include "alignment/Alignment.h"
 #include "alignment/Conditional.h"
@@ -40,10 +42,15 @@
 #include "alignment/Pixels.h"
 #include "alignment/Relative.h"
 #include "alignment/SwapRef.h"
+#include "core/BoundingBox.h"
+#include "core/Frustum.h"
+#include "core/MappedFile.h"
 #include "core/Maths.h"
+#include "core/Parallel.h"
 #include "core/Random.h"
 #include "core/Rectangle.h"
 #include "core/StringUtils.h"
+#include "core/ThreadPool.h"
 #include "core/Time.h"
 #include "core/Tracked.h"
 #include "generators/CircleGenerator.h"
@@ -51,26 +58,41 @@
 #include "generators/ShapeGenerator.h"
 #include "gl/Buffer.h"
 #include "gl/ComputeShader.h"
+#include "gl/DrawIndirectBuffer.h"
+#include "gl/FrameConstants.h"
 #include "gl/IndexBuffer.h"
 #include "gl/Material.h"
 #include "gl/Mesh.h"
+#include "gl/MeshPool.h"
 #include "gl/Model.h"
 #include "gl/OpenGL.h"
+#include "gl/RenderQueue.h"
 #include "gl/RenderRegion.h"
 #include "gl/RenderTarget.h"
 #include "gl/SSBO.h"
 #include "gl/SSBOLayout.h"
 #include "gl/Shader.h"
+#include "gl/State.h"
+#include "gl/StreamBuffer.h"
 #include "gl/Texture.h"
 #include "gl/Texture2D.h"
+#include "gl/Texture2DArray.h"
+#include "gl/Uniform.h"
+#include "gl/UniformBuffer.h"
 #include "gl/Vertex3D.h"
 #include "gl/VertexArray.h"
 #include "gl/VertexBuffer.h"
 #include "gl/VertexBufferLayout.h"
 #include "input/ElementEvents.h"
 #include "input/RawEvents.h"
+#include "res/Async.h"
+#include "res/Image.h"
+#include "res/MeshCache.h"
 #include "res/MeshLoader.h"
+#include "res/ObjParser.h"
 #include "res/ResourceManager.h"
+#include "res/TextureAtlas.h"
+#include "res/UploadQueue.h"
 #include "res/types.h"
 
 #include "glm/gtc/matrix_transform.hpp"
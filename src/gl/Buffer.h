@@ -1,5 +1,6 @@
 #pragma once
 #include "OpenGL.h"
+#include "State.h"
 #include <algorithm>
 
 namespace fc::gl {
@@ -14,6 +15,7 @@ public:
     Buffer() : m_Size(0) { glGenBuffers(1, &m_Handle); }
     ~Buffer() {
         if (m_Handle != 0) {
+            State::forgetBuffer(m_Handle);
             glDeleteBuffers(1, &m_Handle);
         }
     }
@@ -35,9 +37,9 @@ public:
     Buffer(const Buffer&) = delete;
     Buffer& operator=(const Buffer&) = delete;
 
-    inline void bind() const { glBindBuffer(t_Type, m_Handle); }
+    inline void bind() const { State::bindBuffer(t_Type, m_Handle); }
 
-    inline void unbind() const { glBindBuffer(t_Type, 0); }
+    inline void unbind() const { State::bindBuffer(t_Type, 0); }
 
     void setData(const void* data) { setData(data, 0, m_Size); }
 
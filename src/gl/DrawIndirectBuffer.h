@@ -0,0 +1,17 @@
+#pragma once
+#include "Buffer.h"
+
+namespace fc::gl {
+
+// The layout of a command read by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+using DrawIndirectBuffer = Buffer<GL_DRAW_INDIRECT_BUFFER>;
+
+} // namespace fc::gl
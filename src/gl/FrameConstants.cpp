@@ -0,0 +1,27 @@
+#include "FrameConstants.h"
+
+namespace fc::gl {
+
+FrameConstants::FrameConstants() {
+    m_Buffer.setData(nullptr, sizeof(Data), GL_DYNAMIC_DRAW);
+}
+
+void FrameConstants::update(const Camera& camera, const Light& light, float aspectRatio) {
+    Data data;
+    data.view = camera.viewMatrix();
+    data.projection = camera.projectionMatrix(aspectRatio);
+    data.camPos = glm::vec4(camera.getPosition(), 1.0f);
+
+    data.lightPosition = glm::vec4(light.position, 1.0f);
+    data.lightAmbient = glm::vec4(light.ambient, 0.0f);
+    data.lightDiffuse = glm::vec4(light.diffuse, 0.0f);
+    data.lightSpecular = glm::vec4(light.specular, 0.0f);
+
+    m_Buffer.editData(&data, 0, sizeof(Data));
+}
+
+void FrameConstants::bind() const {
+    m_Buffer.bindIndex(BINDING);
+}
+
+} // namespace fc::gl
@@ -0,0 +1,47 @@
+#pragma once
+#include "Camera.h"
+#include "Light.h"
+#include "UniformBuffer.h"
+#include "glm/glm.hpp"
+
+namespace fc::gl {
+
+// The camera and the light of a 3D scene, which are the same for every draw in a frame. They
+// are uploaded to a uniform buffer once per frame, and read by the model shaders from this
+// block:
+//
+//  layout(std140, binding = 0) uniform FrameConstants {
+//      mat4 u_View;
+//      mat4 u_Projection;
+//      vec3 u_CamPos;
+//      Light u_Light; // vec3 position, ambient, diffuse, specular
+//  };
+class FrameConstants {
+public:
+    static constexpr GLuint BINDING = 0;
+
+    // The block in std140 layout, where every vec3 takes up 16 bytes
+    struct Data {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 camPos;
+
+        glm::vec4 lightPosition;
+        glm::vec4 lightAmbient;
+        glm::vec4 lightDiffuse;
+        glm::vec4 lightSpecular;
+    };
+
+private:
+    UniformBuffer m_Buffer;
+
+public:
+    FrameConstants();
+
+    void update(const Camera& camera, const Light& light, float aspectRatio);
+
+    // Binds the buffer to the binding point of the block
+    void bind() const;
+};
+
+} // namespace fc::gl
@@ -1,6 +1,7 @@
 #pragma once
 #include "glm/glm.hpp"
-#include "res/ResourceManager.h"
+#include "res/types.h"
+#include <cstdint>
 
 namespace fc::gl {
 
@@ -30,4 +31,29 @@ struct Material {
           overrideColor(-1, -1, -1, -1) {}
 };
 
+// The values of a material that the model shaders read from the material buffer, in std430
+// layout. The textures are bound to fixed texture units instead.
+struct MaterialData {
+    glm::vec4 ambientColor;  // xyz
+    glm::vec4 diffuseColor;  // xyz
+    glm::vec4 specularColor; // xyz
+    glm::vec4 overrideColor;
+    float shininess;
+    float transparency;
+    uint32_t useSpecularTex;
+    uint32_t useNormalTex;
+
+    MaterialData(const Material& material)
+        : ambientColor(material.ambientColor, 0.0f),
+          diffuseColor(material.diffuseColor, 0.0f),
+          specularColor(material.specularColor, 0.0f),
+          overrideColor(material.overrideColor),
+          shininess(material.shininess),
+          transparency(material.transparency),
+          useSpecularTex(material.specularMap != nullptr),
+          useNormalTex(material.normalMap != nullptr) {}
+
+    bool operator==(const MaterialData&) const = default;
+};
+
 } // namespace fc::gl
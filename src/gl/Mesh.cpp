@@ -3,15 +3,15 @@
 
 namespace fc::gl {
 
-Mesh::Mesh(const std::vector<Vertex3D>& vertices, const std::vector<GLuint>& indices) {
+Mesh::Mesh(std::span<const Vertex3D> vertices, std::span<const GLuint> indices) {
+    for (const Vertex3D& vertex : vertices) {
+        bounds.add(vertex.position);
+    }
+
     VBO.setData(nullptr, vertices.size() * sizeof(vertices[0]), GL_STATIC_DRAW);
     IBO.setData(nullptr, indices.size() * sizeof(indices[0]), GL_STATIC_DRAW);
 
-    VertexBufferLayout layout;
-    layout.push(GL_FLOAT, 3);
-    layout.push(GL_FLOAT, 2);
-    layout.push(GL_FLOAT, 3);
-    layout.push(GL_FLOAT, 3);
+    const VertexBufferLayout layout = vertexLayout();
     VBO.unbind();
     IBO.unbind();
     VAO.bind();
@@ -27,13 +27,26 @@ Mesh::Mesh(const std::vector<Vertex3D>& vertices, const std::vector<GLuint>& ind
     IBO.unbind();
 }
 
+VertexBufferLayout Mesh::vertexLayout() {
+    VertexBufferLayout layout;
+    layout.push(GL_FLOAT, 3); // position
+    layout.push(GL_FLOAT, 2); // texCoord
+    layout.push(GL_FLOAT, 3); // normal
+    layout.push(GL_FLOAT, 3); // tangent
+    return layout;
+}
+
 Mesh& Mesh::operator=(Mesh&& other) {
     std::swap(VAO, other.VAO);
     std::swap(VBO, other.VBO);
     std::swap(IBO, other.IBO);
+    std::swap(bounds, other.bounds);
     return *this;
 }
 
 Mesh::Mesh(Mesh&& other)
-    : VAO(std::move(other.VAO)), VBO(std::move(other.VBO)), IBO(std::move(other.IBO)) {}
+    : VAO(std::move(other.VAO)),
+      VBO(std::move(other.VBO)),
+      IBO(std::move(other.IBO)),
+      bounds(other.bounds) {}
 } // namespace fc::gl
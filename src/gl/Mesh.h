@@ -1,15 +1,16 @@
 #pragma once
+#include "core/BoundingBox.h"
 #include "gl/IndexBuffer.h"
 #include "gl/Vertex3D.h"
 #include "gl/VertexArray.h"
 #include "gl/VertexBuffer.h"
-#include <vector>
+#include <span>
 
 namespace fc::gl {
 
 class Mesh {
 public:
-    Mesh(const std::vector<Vertex3D>& vertices, const std::vector<GLuint>& indices);
+    Mesh(std::span<const Vertex3D> vertices, std::span<const GLuint> indices);
 
     // move assignment
     Mesh& operator=(Mesh&& other);
@@ -19,10 +20,16 @@ public:
     Mesh(const Mesh&) = delete;
     Mesh& operator=(const Mesh&) = delete;
 
+    // The attributes of Vertex3D
+    static VertexBufferLayout vertexLayout();
+
 public:
     VertexArray VAO;
     VertexBuffer VBO;
     IndexBuffer IBO;
+
+    // The bounds of the vertex positions
+    BoundingBox bounds;
 };
 
 } // namespace fc::gl
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "MeshPool.h"
+#include "State.h"
+#include <algorithm>
+
+namespace fc::gl {
+
+MeshPool::MeshPool() {
+    m_VBO.setData(nullptr, 1024 * 1024, GL_STATIC_DRAW);
+    m_IBO.setData(nullptr, 256 * 1024, GL_STATIC_DRAW);
+    setupVertexArray();
+}
+
+const MeshPool::Range& MeshPool::range(const res::MeshHandle& mesh) {
+    auto it = m_Entries.find(mesh.get());
+    // A destroyed mesh may have left its address to this one
+    if (it != m_Entries.end() && it->second.mesh.lock() == mesh)
+        return it->second.range;
+
+    const GLsizeiptr vertexBytes = mesh->VBO.getSize();
+    const GLsizeiptr indexBytes = mesh->IBO.getCount() * static_cast<GLsizeiptr>(sizeof(GLuint));
+
+    bool grown = false;
+    if (m_VertexBytes + vertexBytes > m_VBO.getSize()) {
+        reserve(m_VBO, m_VertexBytes, m_VertexBytes + vertexBytes);
+        grown = true;
+    }
+    if (m_IndexBytes + indexBytes > m_IBO.getSize()) {
+        reserve(m_IBO, m_IndexBytes, m_IndexBytes + indexBytes);
+        grown = true;
+    }
+    if (grown) {
+        setupVertexArray();
+    }
+
+    glCopyNamedBufferSubData(mesh->VBO.getHandle(), m_VBO.getHandle(), 0, m_VertexBytes,
+                             vertexBytes);
+    glCopyNamedBufferSubData(mesh->IBO.getHandle(), m_IBO.getHandle(), 0, m_IndexBytes,
+                             indexBytes);
+
+    // The indices of the mesh start from zero, so they are offset by the base vertex
+    const Range range{static_cast<GLuint>(m_IndexBytes / sizeof(GLuint)),
+                      static_cast<GLuint>(mesh->IBO.getCount()),
+                      static_cast<GLint>(m_VertexBytes / sizeof(Vertex3D))};
+    m_VertexBytes += vertexBytes;
+    m_IndexBytes += indexBytes;
+
+    Entry& entry = m_Entries[mesh.get()];
+    entry = {mesh, range};
+    return entry.range;
+}
+
+void MeshPool::clear() {
+    m_Entries.clear();
+    m_VertexBytes = 0;
+    m_IndexBytes = 0;
+}
+
+void MeshPool::bind() const {
+    m_VAO.bind();
+}
+
+template <typename B> void MeshPool::reserve(B& buffer, GLsizeiptr used, GLsizeiptr required) {
+    B grown;
+    grown.setData(nullptr, std::max(required, buffer.getSize() * 2), GL_STATIC_DRAW);
+    glCopyNamedBufferSubData(buffer.getHandle(), grown.getHandle(), 0, 0, used);
+    buffer = std::move(grown);
+}
+
+void MeshPool::setupVertexArray() {
+    m_VAO.bind();
+    m_VAO.addBuffer(m_VBO, Mesh::vertexLayout());
+    m_VAO.addBuffer(m_IBO);
+    m_VAO.unbind();
+    m_VBO.unbind();
+    m_IBO.unbind();
+}
+
+} // namespace fc::gl
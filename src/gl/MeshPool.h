@@ -0,0 +1,64 @@
+#pragma once
+#include "IndexBuffer.h"
+#include "Mesh.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "res/types.h"
+#include <memory>
+#include <unordered_map>
+
+namespace fc::gl {
+
+// The vertices and indices of many meshes, copied into one shared vertex buffer and one shared
+// index buffer, so that all of them can be drawn with the same vertex array and a single
+// multi-draw call. Meshes are copied in on the GPU the first time they are requested.
+//
+// The pool only grows: the space of a mesh that is destroyed is not reused until clear() is
+// called. It is meant for geometry that stays loaded.
+class MeshPool {
+public:
+    // Where a mesh is in the pool, in the terms of a draw command
+    struct Range {
+        GLuint firstIndex;
+        GLuint indexCount;
+        GLint baseVertex;
+    };
+
+private:
+    struct Entry {
+        std::weak_ptr<Mesh> mesh;
+        Range range;
+    };
+
+    VertexArray m_VAO;
+    VertexBuffer m_VBO;
+    IndexBuffer m_IBO;
+
+    GLsizeiptr m_VertexBytes = 0;
+    GLsizeiptr m_IndexBytes = 0;
+
+    std::unordered_map<const Mesh*, Entry> m_Entries;
+
+public:
+    MeshPool();
+
+    MeshPool(const MeshPool&) = delete;
+    MeshPool& operator=(const MeshPool&) = delete;
+
+    // The range of the mesh, which is copied into the pool if it is not there yet
+    const Range& range(const res::MeshHandle& mesh);
+
+    // Forgets every mesh, making the whole pool free again
+    void clear();
+
+    // Binds the vertex array reading from the pool
+    void bind() const;
+
+private:
+    // Grows the buffer to hold at least the given number of bytes, keeping its content
+    template <typename B> void reserve(B& buffer, GLsizeiptr used, GLsizeiptr required);
+
+    void setupVertexArray();
+};
+
+} // namespace fc::gl
@@ -1,88 +1,216 @@
 #include "Model.h"
-#include "RenderRegion.h"
+#include "State.h"
 #include "Texture2D.h"
-#include "glm/gtc/type_ptr.hpp"
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 
 namespace fc::gl {
 
-void Model::render(const Window& window, const Camera& camera, const Light& light) {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+void Model::render(const FrameConstants& frame) {
+    if (subMeshes.empty())
+        return;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    const Rectangle viewport = gl::RenderRegion::currentViewport();
+    applyRenderState();
+    const Uniforms& u = prepare();
 
     shader->bind();
-    shader->setUniformMat4f("u_View", camera.viewMatrix());
-    shader->setUniformMat4f("u_Projection",
-                            camera.projectionMatrix(viewport.width / viewport.height));
-    shader->setUniformMat4f("u_Transform", transform);
-    const glm::vec3 cameraPos = camera.getPosition();
-    shader->setUniform3fv("u_CamPos", glm::value_ptr(cameraPos));
-    for (auto& [mesh, material] : subMeshes) {
+    frame.bind();
+    bindModelState(u);
 
-        mesh->VAO.bind();
+    for (size_t i = 0; i < subMeshes.size(); i++) {
+        const auto& [mesh, material] = subMeshes[i];
 
-        shader->setUniform1f("u_Material.shininess", material.shininess);
-        shader->setUniform1f("u_Material.transparency", material.transparency);
+        mesh->VAO.bind();
 
         if (material.diffuseTexture) {
-            material.diffuseTexture->bind(1);
-            shader->setUniform1i("u_Material.diffuseTex", 1);
-        } else {
-            shader->setUniform3fv("u_Material.ambientColor", &material.ambientColor[0]);
-            shader->setUniform3fv("u_Material.diffuseColor", &material.diffuseColor[0]);
-            // shader.setUniform1i("u_Material.diffuseTex", 0);
+            material.diffuseTexture->bind(DIFFUSE_UNIT);
         }
-
         if (material.specularMap) {
-            material.specularMap->bind(2);
-            shader->setUniform1i("u_Material.specularTex", 2);
-            shader->setUniform1i("u_Material.useSpecularTex", true);
-        } else {
-            if (shader->uniformExists("u_Material.useSpecularTex")) {
-                shader->setUniform1i("u_Material.useSpecularTex", false);
-            }
-            shader->setUniform3fv("u_Material.specularColor", &material.specularColor[0]);
-            // shader.setUniform1i("u_Material.specularTex", 0);
+            material.specularMap->bind(SPECULAR_UNIT);
         }
-
         if (material.normalMap) {
-            material.normalMap->bind(3);
-            shader->setUniform1i("u_Material.normalTex", 3);
-            shader->setUniform1i("u_Material.useNormalTex", true);
+            material.normalMap->bind(NORMAL_UNIT);
         }
-        // else {
-        // shader.setUniform1i("u_Material.normalTex", 0);
-        //}
-
-        shader->setUniform3fv("u_Light.position", &light.position[0]);
-        shader->setUniform3fv("u_Light.ambient", &light.ambient[0]);
-        shader->setUniform3fv("u_Light.diffuse", &light.diffuse[0]);
-        shader->setUniform3fv("u_Light.specular", &light.specular[0]);
 
-        shader->setUniform4fv("u_Material.overrideColor", &material.overrideColor[0]);
+        u.materialIndex.set(static_cast<GLuint>(i));
 
         GLsizei amtIndices = mesh->IBO.getCount();
         mesh->IBO.bind();
-        glDrawElements(GL_TRIANGLES, amtIndices, GL_UNSIGNED_INT, nullptr);
+        glDrawElementsInstanced(GL_TRIANGLES, amtIndices, GL_UNSIGNED_INT, nullptr,
+                                drawnInstanceCount());
+    }
+}
+
+void Model::updateMaterials() {
+    m_UploadedMaterials.clear();
+    m_UploadedMaterials.reserve(subMeshes.size());
+    for (const auto& [mesh, material] : subMeshes) {
+        m_UploadedMaterials.emplace_back(material);
+    }
+
+    const GLuint count = static_cast<GLuint>(m_UploadedMaterials.size());
+    if (!m_Materials) {
+        SSBOLayout layout;
+        layout.addVariableSizedComponent<MaterialData>(count);
+        m_Materials = std::make_unique<SSBO>(layout);
+    } else {
+        m_Materials->resizeLast(count);
+    }
+    m_Materials->setData(m_UploadedMaterials.data(), 0);
+}
+
+bool Model::materialsChanged() const {
+    if (!m_Materials || m_UploadedMaterials.size() != subMeshes.size())
+        return true;
+
+    for (size_t i = 0; i < subMeshes.size(); i++) {
+        if (MaterialData(subMeshes[i].second) != m_UploadedMaterials[i])
+            return true;
+    }
+    return false;
+}
+
+void Model::setInstances(std::vector<glm::mat4> instances) {
+    m_Instances = std::move(instances);
+    m_InstancesChanged = true;
+    m_InstanceBoundsChanged = true;
+}
+
+void Model::addInstance(const glm::mat4& instance) {
+    m_Instances.push_back(instance);
+    m_InstancesChanged = true;
+    m_InstanceBoundsChanged = true;
+}
+
+void Model::setInstance(size_t index, const glm::mat4& instance) {
+    if (index >= m_Instances.size()) {
+        throw std::out_of_range("Instance index " + std::to_string(index)
+                                + " out of range for a model with "
+                                + std::to_string(m_Instances.size()) + " instances");
+    }
+    m_Instances[index] = instance;
+    m_InstancesChanged = true;
+    m_InstanceBoundsChanged = true;
+}
+
+void Model::clearInstances() {
+    m_Instances.clear();
+    m_InstancesChanged = true;
+    m_InstanceBoundsChanged = true;
+}
+
+BoundingBox Model::bounds() const {
+    BoundingBox result;
+    for (const auto& [mesh, material] : subMeshes) {
+        result.add(mesh->bounds);
     }
+    return result;
+}
+
+BoundingBox Model::worldBounds() {
+    const BoundingBox local = bounds();
+    if (m_Instances.empty())
+        return local.transformed(transform);
+
+    if (m_InstanceBoundsChanged || !(local == m_InstanceBoundsSource)) {
+        m_InstanceBounds = BoundingBox();
+        for (const glm::mat4& instance : m_Instances) {
+            m_InstanceBounds.add(local.transformed(instance));
+        }
+        m_InstanceBoundsSource = local;
+        m_InstanceBoundsChanged = false;
+    }
+    return m_InstanceBounds.transformed(transform);
+}
+
+void Model::updateInstanceBuffer() {
+    static const glm::mat4 IDENTITY(1.0f);
+    const glm::mat4* data = m_Instances.empty() ? &IDENTITY : m_Instances.data();
+    const GLuint count = static_cast<GLuint>(drawnInstanceCount());
+
+    if (!m_InstanceBuffer) {
+        SSBOLayout layout;
+        layout.addVariableSizedComponent<glm::mat4>(count);
+        m_InstanceBuffer = std::make_unique<SSBO>(layout);
+    } else {
+        m_InstanceBuffer->resizeLast(count);
+    }
+    m_InstanceBuffer->setData(data, 0);
+    m_InstancesChanged = false;
+}
+
+const Model::Uniforms& Model::prepare() {
+    if (materialsChanged()) {
+        updateMaterials();
+    }
+    if (m_InstancesChanged) {
+        updateInstanceBuffer();
+    }
+
+    if (m_UniformsProgram == shader->handle())
+        return m_Uniforms;
+
+    const Shader& s = *shader;
+    m_Uniforms.transform = s.uniform("u_Transform");
+    m_Uniforms.materialIndex = s.uniform("u_MaterialIndex");
+
+    // The texture units never change, so the samplers are set only once
+    s.uniform("u_DiffuseTex", false).set(DIFFUSE_UNIT);
+    s.uniform("u_SpecularTex", false).set(SPECULAR_UNIT);
+    s.uniform("u_NormalTex", false).set(NORMAL_UNIT);
+
+    m_UniformsProgram = shader->handle();
+    return m_Uniforms;
+}
+
+void Model::bindModelState(const Uniforms& uniforms) const {
+    m_Materials->bindIndex(MATERIAL_BINDING);
+    m_InstanceBuffer->bindIndex(INSTANCE_BINDING);
+    uniforms.transform.set(transform);
+}
+
+void Model::applyRenderState() {
+    State::enable(GL_DEPTH_TEST);
+    State::depthFunc(GL_LESS);
+
+    State::enable(GL_BLEND);
+    State::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    State::enable(GL_CULL_FACE);
+    State::cullFace(GL_BACK);
 }
 
 Model& Model::operator=(Model&& other) {
     std::swap(shader, other.shader);
     subMeshes.swap(other.subMeshes);
+    std::swap(transform, other.transform);
+    std::swap(m_Uniforms, other.m_Uniforms);
+    std::swap(m_UniformsProgram, other.m_UniformsProgram);
+    std::swap(m_Materials, other.m_Materials);
+    std::swap(m_UploadedMaterials, other.m_UploadedMaterials);
+    std::swap(m_Instances, other.m_Instances);
+    std::swap(m_InstanceBuffer, other.m_InstanceBuffer);
+    std::swap(m_InstancesChanged, other.m_InstancesChanged);
+    std::swap(m_InstanceBounds, other.m_InstanceBounds);
+    std::swap(m_InstanceBoundsSource, other.m_InstanceBoundsSource);
+    std::swap(m_InstanceBoundsChanged, other.m_InstanceBoundsChanged);
     return *this;
 }
 
 Model::Model(Model&& other) {
     shader = std::move(other.shader);
     subMeshes = std::move(other.subMeshes);
+    transform = other.transform;
+    m_Uniforms = other.m_Uniforms;
+    m_UniformsProgram = other.m_UniformsProgram;
+    m_Materials = std::move(other.m_Materials);
+    m_UploadedMaterials = std::move(other.m_UploadedMaterials);
+    m_Instances = std::move(other.m_Instances);
+    m_InstanceBuffer = std::move(other.m_InstanceBuffer);
+    m_InstancesChanged = other.m_InstancesChanged;
+    m_InstanceBounds = other.m_InstanceBounds;
+    m_InstanceBoundsSource = other.m_InstanceBoundsSource;
+    m_InstanceBoundsChanged = other.m_InstanceBoundsChanged;
 }
 } // namespace fc::gl
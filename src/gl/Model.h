@@ -1,17 +1,31 @@
 #pragma once
-#include "Camera.h"
-#include "Light.h"
+#include "FrameConstants.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "SSBO.h"
 #include "Shader.h"
-#include "Window.h"
 #include "res/types.h"
+#include <memory>
 #include <utility>
 
 namespace fc::gl {
 
 class Model {
 public:
+    // The binding point of the material buffer, read by the shaders as
+    //  layout(std430, binding = 0) readonly buffer Materials { Material u_Materials[]; };
+    // and indexed with the u_MaterialIndex uniform
+    static constexpr GLuint MATERIAL_BINDING = 0;
+    // The binding point of the instance transforms, read by the shaders as
+    //  layout(std430, binding = 1) readonly buffer Instances { mat4 u_Instances[]; };
+    // and indexed with gl_InstanceID
+    static constexpr GLuint INSTANCE_BINDING = 1;
+
+    // The texture units of the material textures
+    static constexpr GLint DIFFUSE_UNIT = 1;
+    static constexpr GLint SPECULAR_UNIT = 2;
+    static constexpr GLint NORMAL_UNIT = 3;
+
     // ModelID, Material
     std::vector<std::pair<fc::res::MeshHandle, gl::Material>> subMeshes;
 
@@ -22,7 +36,31 @@ public:
 public:
     Model() = default;
 
-    void render(const Window& window, const Camera& camera, const Light& light);
+    // Draws the model with the camera and light of the frame constants
+    void render(const FrameConstants& frame);
+
+    // Uploads the materials of the submeshes. Materials that were changed, added or removed are
+    // noticed and uploaded before the model is drawn, so this only uploads them ahead of time.
+    void updateMaterials();
+
+    // Instances place copies of the model at transforms relative to `transform`, and all of
+    // them are drawn with one instanced draw per submesh. A model without instances is drawn
+    // once, at `transform`. setInstance throws std::out_of_range for an index that was not added.
+    void setInstances(std::vector<glm::mat4> instances);
+    void addInstance(const glm::mat4& instance);
+    void setInstance(size_t index, const glm::mat4& instance);
+    void clearInstances();
+
+    const std::vector<glm::mat4>& instances() const { return m_Instances; }
+    // The bounds of the submeshes, before any transform
+    BoundingBox bounds() const;
+    // The bounds of the model and all of its instances, after their transforms
+    BoundingBox worldBounds();
+
+    // The number of copies drawn, which is at least one
+    GLsizei drawnInstanceCount() const {
+        return m_Instances.empty() ? 1 : static_cast<GLsizei>(m_Instances.size());
+    }
 
     // move assignment
     Model& operator=(Model&& other);
@@ -31,6 +69,48 @@ public:
 
     Model(const Model&) = delete;
     Model& operator=(const Model&) = delete;
+
+private:
+    friend class RenderQueue;
+
+    // The uniforms of the shader, looked up when the model is first rendered with it
+    struct Uniforms {
+        Uniform transform;
+        Uniform materialIndex;
+    };
+
+    Uniforms m_Uniforms;
+    // The program the uniforms were looked up in
+    GLuint m_UniformsProgram = 0;
+
+    // One MaterialData per submesh, and a copy of what was uploaded to notice changes
+    std::unique_ptr<SSBO> m_Materials;
+    std::vector<MaterialData> m_UploadedMaterials;
+
+    std::vector<glm::mat4> m_Instances;
+    // The transforms of the instances, or a single identity transform if there are none
+    std::unique_ptr<SSBO> m_InstanceBuffer;
+    bool m_InstancesChanged = true;
+
+    // The bounds of all instances relative to `transform`, and the model bounds they were
+    // computed from
+    BoundingBox m_InstanceBounds;
+    BoundingBox m_InstanceBoundsSource;
+    bool m_InstanceBoundsChanged = true;
+
+    // Uploads the materials and instances if they changed, and looks up the uniforms if the
+    // shader changed
+    const Uniforms& prepare();
+
+    // Binds the buffers of the model and sets its transform. The shader must be bound.
+    void bindModelState(const Uniforms& uniforms) const;
+
+    // Whether a material differs from the one uploaded, or submeshes were added or removed
+    bool materialsChanged() const;
+    void updateInstanceBuffer();
+
+    // The pipeline state shared by every model
+    static void applyRenderState();
 };
 
 } // namespace fc::gl
@@ -0,0 +1,247 @@
+#include "RenderQueue.h"
+#include "State.h"
+#include "Texture2D.h"
+#include <algorithm>
+#include <bit>
+
+namespace fc::gl {
+
+// The layout of the sort keys, from the most significant bit
+//  opaque:      0 | shader (10) | textures (20) | mesh (17) | depth (16)
+//  transparent: 1 | inverted depth (32) | shader (10) | textures (21)
+static constexpr int SHADER_BITS = 10;
+static constexpr int TEXTURE_BITS = 20;
+static constexpr int MESH_BITS = 17;
+static constexpr int OPAQUE_DEPTH_BITS = 16;
+static constexpr uint64_t TRANSPARENT_BIT = uint64_t(1) << 63;
+
+// A key that orders non-negative depths, from the bits of the float. The floats of positive
+// numbers are ordered like their bits, and the sign bit is always zero.
+static uint32_t depthBits(float depth) {
+    return std::bit_cast<uint32_t>(std::max(depth, 0.0f));
+}
+
+void RenderQueue::clear(const glm::mat4& view, const glm::mat4& projection) {
+    m_Items.clear();
+    m_ShaderIds.clear();
+    m_MeshIds.clear();
+    m_TextureIds.clear();
+    m_View = view;
+    m_Frustum = Frustum(projection * view);
+    m_Stats = Stats();
+}
+
+void RenderQueue::add(Model& model) {
+    if (!model.shader)
+        return;
+
+    if (!m_Frustum.intersects(model.worldBounds())) {
+        m_Stats.culled += static_cast<uint32_t>(model.subMeshes.size());
+        return;
+    }
+    // The submeshes of instanced models are not culled one by one, since they are drawn for
+    // every instance anyway
+    const bool cullSubMeshes = model.instances().empty() && model.subMeshes.size() > 1;
+
+    // The distance in front of the camera, of the origin of the model
+    const glm::vec4 viewPosition = m_View * model.transform[3];
+    const uint32_t depth = depthBits(-viewPosition.z);
+
+    const uint64_t shader = idOf(m_ShaderIds, model.shader.get(), SHADER_BITS);
+
+    for (size_t i = 0; i < model.subMeshes.size(); i++) {
+        const auto& [mesh, material] = model.subMeshes[i];
+        if (cullSubMeshes && !m_Frustum.intersects(mesh->bounds.transformed(model.transform))) {
+            m_Stats.culled++;
+            continue;
+        }
+
+        const TextureSet textures = textureSet(material);
+
+        uint64_t key;
+        if (isTransparent(material)) {
+            const uint64_t textureId = idOf(m_TextureIds, textures, TEXTURE_BITS + 1);
+            key = TRANSPARENT_BIT | (uint64_t(~depth) << (SHADER_BITS + TEXTURE_BITS + 1))
+                  | (shader << (TEXTURE_BITS + 1)) | textureId;
+        } else {
+            const uint64_t textureId = idOf(m_TextureIds, textures, TEXTURE_BITS);
+            const uint64_t meshId = idOf(m_MeshIds, mesh.get(), MESH_BITS);
+            key = (shader << (TEXTURE_BITS + MESH_BITS + OPAQUE_DEPTH_BITS))
+                  | (textureId << (MESH_BITS + OPAQUE_DEPTH_BITS)) | (meshId << OPAQUE_DEPTH_BITS)
+                  | (depth >> (32 - OPAQUE_DEPTH_BITS));
+        }
+
+        m_Items.push_back({key, &model, static_cast<uint32_t>(i)});
+    }
+}
+
+void RenderQueue::submit(const FrameConstants& frame) {
+    // Keep the culling counted while the queue was filled
+    m_Stats = Stats{.culled = m_Stats.culled};
+    if (m_Items.empty())
+        return;
+
+    sortItems();
+
+    Model::applyRenderState();
+    frame.bind();
+
+    const Shader* shader = nullptr;
+    Model* model = nullptr;
+    const Model::Uniforms* uniforms = nullptr;
+    const Mesh* mesh = nullptr;
+    TextureSet textures{};
+
+    for (const Item& item : m_Items) {
+        const auto& [subMesh, material] = item.model->subMeshes[item.subMesh];
+
+        if (item.model->shader.get() != shader) {
+            shader = item.model->shader.get();
+            shader->bind();
+            // The uniforms of a model are looked up per shader
+            model = nullptr;
+            m_Stats.shaderChanges++;
+        }
+
+        if (item.model != model) {
+            model = item.model;
+            uniforms = &model->prepare();
+            model->bindModelState(*uniforms);
+            m_Stats.modelChanges++;
+        }
+
+        if (subMesh.get() != mesh) {
+            mesh = subMesh.get();
+            mesh->VAO.bind();
+            mesh->IBO.bind();
+            m_Stats.meshChanges++;
+        }
+
+        bindTextures(textureSet(material), textures);
+
+        uniforms->materialIndex.set(item.subMesh);
+
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(mesh->IBO.getCount()),
+                                GL_UNSIGNED_INT, nullptr, model->drawnInstanceCount());
+        m_Stats.draws++;
+    }
+}
+
+void RenderQueue::submitIndirect(const FrameConstants& frame, MeshPool& pool) {
+    m_Stats = Stats{.culled = m_Stats.culled};
+    if (m_Items.empty())
+        return;
+
+    sortItems();
+
+    // Every submesh becomes a command, with its material and the world transforms of its
+    // instances in buffers shared by all commands. A command finds its material from the
+    // index of the first command of its call and gl_DrawID, and its transforms from its base
+    // instance.
+    m_Commands.clear();
+    m_DrawMaterials.clear();
+    m_DrawTransforms.clear();
+    for (const Item& item : m_Items) {
+        const Model& model = *item.model;
+        const auto& [mesh, material] = model.subMeshes[item.subMesh];
+        const MeshPool::Range& range = pool.range(mesh);
+
+        const GLuint baseInstance = static_cast<GLuint>(m_DrawTransforms.size());
+        if (model.instances().empty()) {
+            m_DrawTransforms.push_back(model.transform);
+        } else {
+            for (const glm::mat4& instance : model.instances()) {
+                m_DrawTransforms.push_back(model.transform * instance);
+            }
+        }
+
+        m_Commands.push_back({range.indexCount, static_cast<GLuint>(model.drawnInstanceCount()),
+                              range.firstIndex, range.baseVertex, baseInstance});
+        m_DrawMaterials.emplace_back(material);
+    }
+
+    upload(m_MaterialBuffer, m_DrawMaterials);
+    upload(m_TransformBuffer, m_DrawTransforms);
+    const GLsizeiptr commandBytes = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+    if (m_CommandBuffer.getSize() < commandBytes) {
+        m_CommandBuffer.setData(nullptr, std::bit_ceil(static_cast<size_t>(commandBytes)),
+                                GL_DYNAMIC_DRAW);
+    }
+    m_CommandBuffer.editData(m_Commands.data(), 0, commandBytes);
+
+    Model::applyRenderState();
+    frame.bind();
+    pool.bind();
+    m_CommandBuffer.bind();
+    m_MaterialBuffer->bindIndex(Model::MATERIAL_BINDING);
+    m_TransformBuffer->bindIndex(Model::INSTANCE_BINDING);
+
+    const Shader* shader = nullptr;
+    TextureSet textures{};
+
+    size_t first = 0;
+    while (first < m_Items.size()) {
+        // The submeshes drawn by one call share the shader and the textures
+        const Item& item = m_Items[first];
+        const TextureSet itemTextures
+            = textureSet(item.model->subMeshes[item.subMesh].second);
+        size_t end = first + 1;
+        while (end < m_Items.size() && m_Items[end].model->shader == item.model->shader
+               && textureSet(m_Items[end].model->subMeshes[m_Items[end].subMesh].second)
+                      == itemTextures) {
+            end++;
+        }
+
+        if (item.model->shader.get() != shader) {
+            shader = item.model->shader.get();
+            shader->bind();
+            m_Stats.shaderChanges++;
+        }
+        bindTextures(itemTextures, textures);
+
+        // The transforms of the commands are already in world space
+        const Model::Uniforms& uniforms = item.model->prepare();
+        uniforms.transform.set(glm::mat4(1.0f));
+        uniforms.materialIndex.set(static_cast<GLuint>(first));
+
+        glMultiDrawElementsIndirect(
+            GL_TRIANGLES, GL_UNSIGNED_INT,
+            reinterpret_cast<const void*>(first * sizeof(DrawElementsIndirectCommand)),
+            static_cast<GLsizei>(end - first), 0);
+        m_Stats.draws++;
+        m_Stats.indirectCommands += static_cast<uint32_t>(end - first);
+
+        first = end;
+    }
+}
+
+void RenderQueue::sortItems() {
+    std::sort(m_Items.begin(), m_Items.end(),
+              [](const Item& a, const Item& b) { return a.key < b.key; });
+}
+
+RenderQueue::TextureSet RenderQueue::textureSet(const Material& material) {
+    return {material.diffuseTexture.get(), material.specularMap.get(), material.normalMap.get()};
+}
+
+void RenderQueue::bindTextures(const TextureSet& textures, TextureSet& bound) {
+    constexpr std::array<GLint, 3> TEXTURE_UNITS{Model::DIFFUSE_UNIT, Model::SPECULAR_UNIT,
+                                                 Model::NORMAL_UNIT};
+    for (size_t i = 0; i < textures.size(); i++) {
+        // A missing texture leaves the previous one bound, like Model::render does
+        if (textures[i] != nullptr && textures[i] != bound[i]) {
+            textures[i]->bind(TEXTURE_UNITS[i]);
+            bound[i] = textures[i];
+            m_Stats.textureChanges++;
+        }
+    }
+}
+
+bool RenderQueue::isTransparent(const Material& material) {
+    // An override color with negative values means no override color
+    if (material.overrideColor.x >= 0.0f)
+        return material.overrideColor.a < 1.0f;
+    return material.transparency < 1.0f;
+}
+
+} // namespace fc::gl
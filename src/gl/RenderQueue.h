@@ -0,0 +1,123 @@
+#pragma once
+#include "DrawIndirectBuffer.h"
+#include "FrameConstants.h"
+#include "MeshPool.h"
+#include "Model.h"
+#include "SSBO.h"
+#include "core/Frustum.h"
+#include "glm/glm.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace fc::gl {
+
+// Collects the submeshes of many models and draws them in an order that changes as little
+// state as possible. Every submesh is given a 64 bit sort key:
+//  - opaque submeshes are drawn first, grouped by shader, then by textures, then by mesh, and
+//    front to back within a group
+//  - transparent submeshes are drawn after them, back to front, so that they blend over what
+//    is behind them
+// When submitting, only the state that differs from the previous draw is set. Submeshes
+// outside the view frustum are not queued at all.
+//
+// The queue can also be submitted with multi-draw indirect, for scenes of many meshes that
+// stay loaded. The meshes are then copied into a MeshPool, and every run of submeshes that
+// share a shader and textures is drawn with a single glMultiDrawElementsIndirect call.
+class RenderQueue {
+public:
+    // What submitting the queue did, to see how well the draws shared state
+    struct Stats {
+        uint32_t draws = 0;
+        // Submeshes that were not queued because they were outside the view
+        uint32_t culled = 0;
+        uint32_t shaderChanges = 0;
+        // The material buffer and transform of another model
+        uint32_t modelChanges = 0;
+        uint32_t meshChanges = 0;
+        uint32_t textureChanges = 0;
+        // The draw commands of the multi-draw calls, when submitted indirectly
+        uint32_t indirectCommands = 0;
+    };
+
+private:
+    using TextureSet = std::array<const Texture2D*, 3>;
+
+    struct Item {
+        uint64_t key;
+        Model* model;
+        uint32_t subMesh;
+    };
+
+    std::vector<Item> m_Items;
+    glm::mat4 m_View = glm::mat4(1.0f);
+    Frustum m_Frustum{glm::mat4(1.0f)};
+
+    // Small ids for the sort keys, given in the order things are first seen in a frame
+    std::unordered_map<const Shader*, uint32_t> m_ShaderIds;
+    std::unordered_map<const Mesh*, uint32_t> m_MeshIds;
+    std::map<TextureSet, uint32_t> m_TextureIds;
+
+    // The data of indirect submission, rebuilt every time
+    std::vector<DrawElementsIndirectCommand> m_Commands;
+    std::vector<MaterialData> m_DrawMaterials;
+    std::vector<glm::mat4> m_DrawTransforms;
+    DrawIndirectBuffer m_CommandBuffer;
+    std::unique_ptr<SSBO> m_MaterialBuffer;
+    std::unique_ptr<SSBO> m_TransformBuffer;
+
+    Stats m_Stats;
+
+public:
+    // Empties the queue. The view matrix is used to sort the submeshes by depth, and together
+    // with the projection matrix to cull them.
+    void clear(const glm::mat4& view, const glm::mat4& projection);
+
+    // Queues every submesh of the model. The model must stay alive until the queue is submitted.
+    void add(Model& model);
+
+    // Sorts and draws the queued submeshes
+    void submit(const FrameConstants& frame);
+    // Sorts and draws the queued submeshes from the mesh pool, with multi-draw indirect
+    void submitIndirect(const FrameConstants& frame, MeshPool& pool);
+
+    size_t size() const { return m_Items.size(); }
+    const Stats& stats() const { return m_Stats; }
+
+private:
+    static bool isTransparent(const Material& material);
+    static TextureSet textureSet(const Material& material);
+
+    void sortItems();
+    // Binds the textures that are set and differ from the bound ones
+    void bindTextures(const TextureSet& textures, TextureSet& bound);
+
+    // Writes the data to the start of the SSBO, growing it if it is too small
+    template <typename T>
+    static void upload(std::unique_ptr<SSBO>& ssbo, const std::vector<T>& data) {
+        const GLuint count = static_cast<GLuint>(data.size());
+        if (!ssbo) {
+            SSBOLayout layout;
+            layout.addVariableSizedComponent<T>(std::bit_ceil(std::max(count, 1u)));
+            ssbo = std::make_unique<SSBO>(layout);
+        } else if (ssbo->getLayout().getComponent(0).getCount() < count) {
+            ssbo->resizeLast(std::bit_ceil(count));
+        }
+        ssbo->editData(data.data(), 0, count * sizeof(T));
+    }
+
+    // The id, or the largest id that fits in the given number of bits if there are too many.
+    // The ids only affect the order of the draws, not what is drawn.
+    template <typename Map, typename Key> static uint64_t idOf(Map& ids, const Key& key, int bits) {
+        auto [it, inserted] = ids.try_emplace(key, static_cast<uint32_t>(ids.size()));
+        const uint64_t max = (uint64_t(1) << bits) - 1;
+        return std::min<uint64_t>(it->second, max);
+    }
+};
+
+} // namespace fc::gl
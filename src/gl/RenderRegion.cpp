@@ -1,22 +1,23 @@
 #include "RenderRegion.h"
 #include "OpenGL.h"
+#include "RenderTarget.h"
+#include "State.h"
 
 void fc::gl::RenderRegion::pushAbsolute(const Rectangle& region) {
     pushAbsolute(region, Mode::All);
 }
 
 void fc::gl::RenderRegion::pushAbsolute(const Rectangle& region, Mode mode) {
+    notifyChange();
     stack.emplace_back(region, mode);
 
     if (static_cast<uint8_t>(mode) & static_cast<uint8_t>(Mode::Viewport)) {
-        glViewport(static_cast<GLint>(region.x), static_cast<GLint>(region.y),
-                   static_cast<GLsizei>(region.width), static_cast<GLsizei>(region.height));
+        applyViewport(region);
     }
 
     if (static_cast<uint8_t>(mode) & static_cast<uint8_t>(Mode::Scissor)) {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(static_cast<GLint>(region.x), static_cast<GLint>(region.y),
-                  static_cast<GLsizei>(region.width), static_cast<GLsizei>(region.height));
+        State::enable(GL_SCISSOR_TEST);
+        applyScissor(region);
     }
 }
 
@@ -37,17 +38,16 @@ void fc::gl::RenderRegion::push(const Rectangle& region, Mode mode) {
         region_ = region_.intersection(currentScissor());
     }
 
+    notifyChange();
     stack.emplace_back(region_, mode);
 
     if (static_cast<uint8_t>(mode) & static_cast<uint8_t>(Mode::Viewport)) {
-        glViewport(static_cast<GLint>(region_.x), static_cast<GLint>(region_.y),
-                   static_cast<GLsizei>(region_.width), static_cast<GLsizei>(region_.height));
+        applyViewport(region_);
     }
 
     if (static_cast<uint8_t>(mode) & static_cast<uint8_t>(Mode::Scissor)) {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(static_cast<GLint>(region_.x), static_cast<GLint>(region_.y),
-                  static_cast<GLsizei>(region_.width), static_cast<GLsizei>(region_.height));
+        State::enable(GL_SCISSOR_TEST);
+        applyScissor(region_);
     }
 }
 
@@ -55,26 +55,91 @@ void fc::gl::RenderRegion::pop() {
     if (stack.empty()) {
         return;
     }
+    // The region of a render target is only popped with the target
+    if (!targets.empty() && stack.size() == targets.back().stackSize + 1) {
+        return;
+    }
 
+    notifyChange();
     stack.pop_back();
 
-    const Rectangle viewport = currentViewport();
-    const Rectangle scissor = currentScissor();
+    applyViewport(currentViewport());
+    applyScissor(currentScissor());
+}
+
+void fc::gl::RenderRegion::pushTarget(const RenderTarget& target, const Rectangle& region) {
+    notifyChange();
+    notifyTargetChange();
+
+    targets.push_back({&target, region.position, stack.size()});
+    stack.emplace_back(region, Mode::Scissor);
+
+    target.bind();
+    State::enable(GL_SCISSOR_TEST);
+    applyViewport(currentViewport());
+    applyScissor(region);
+}
+
+void fc::gl::RenderRegion::popTarget() {
+    if (targets.empty()) {
+        return;
+    }
+
+    notifyChange();
+    notifyTargetChange();
+
+    stack.erase(stack.begin() + targets.back().stackSize, stack.end());
+    targets.pop_back();
+
+    if (targets.empty()) {
+        RenderTarget::unbind();
+    } else {
+        targets.back().target->bind();
+    }
+    applyViewport(currentViewport());
+    applyScissor(currentScissor());
+}
 
-    glViewport(static_cast<GLint>(viewport.x), static_cast<GLint>(viewport.y),
-               static_cast<GLsizei>(viewport.width), static_cast<GLsizei>(viewport.height));
-    glScissor(static_cast<GLint>(scissor.x), static_cast<GLint>(scissor.y),
-              static_cast<GLsizei>(scissor.width), static_cast<GLsizei>(scissor.height));
+glm::vec2 fc::gl::RenderRegion::targetOrigin() {
+    if (targets.empty()) {
+        return {0.0f, 0.0f};
+    }
+    return targets.back().origin;
 }
 
 void fc::gl::RenderRegion::applyBase() {
-    glEnable(GL_SCISSOR_TEST);
+    notifyChange();
+    State::enable(GL_SCISSOR_TEST);
     glViewport(static_cast<GLint>(base.x), static_cast<GLint>(base.y),
                static_cast<GLsizei>(base.width), static_cast<GLsizei>(base.height));
     glScissor(static_cast<GLint>(base.x), static_cast<GLint>(base.y),
               static_cast<GLsizei>(base.width), static_cast<GLsizei>(base.height));
 }
 
+void fc::gl::RenderRegion::notifyChange() {
+    for (ChangeCallback& callback : changeCallbacks) {
+        callback();
+    }
+}
+
+void fc::gl::RenderRegion::notifyTargetChange() {
+    for (ChangeCallback& callback : targetCallbacks) {
+        callback();
+    }
+}
+
+void fc::gl::RenderRegion::applyViewport(const Rectangle& region) {
+    const glm::vec2 origin = targetOrigin();
+    glViewport(static_cast<GLint>(region.x - origin.x), static_cast<GLint>(region.y - origin.y),
+               static_cast<GLsizei>(region.width), static_cast<GLsizei>(region.height));
+}
+
+void fc::gl::RenderRegion::applyScissor(const Rectangle& region) {
+    const glm::vec2 origin = targetOrigin();
+    glScissor(static_cast<GLint>(region.x - origin.x), static_cast<GLint>(region.y - origin.y),
+              static_cast<GLsizei>(region.width), static_cast<GLsizei>(region.height));
+}
+
 fc::Rectangle fc::gl::RenderRegion::currentViewport() {
     if (stack.empty()) {
         return base;
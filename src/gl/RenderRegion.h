@@ -1,12 +1,20 @@
 #pragma once
 
 #include "core/Rectangle.h"
+#include "fiv.hpp"
+#include "glm/glm.hpp"
+#include <functional>
 #include <utility>
+#include <vector>
 
 namespace fc::gl {
 
+class RenderTarget;
+
 class RenderRegion {
 public:
+    using ChangeCallback = std::function<void()>;
+
     enum class Mode : uint8_t {
         Viewport = 0b01,
         Scissor = 0b10,
@@ -21,15 +29,63 @@ public:
     static void push(const Rectangle& region);
     static void push(const Rectangle& region, Mode mode);
 
+    // Does not pop the region of a render target, use popTarget for that.
     static void pop();
 
+    // Redirects rendering into the target, which stands in for the given region of the window.
+    // Regions keep using window coordinates, and are offset to the target when applied. The
+    // scissor is set to the region, while the viewport stays the same.
+    static void pushTarget(const RenderTarget& target, const Rectangle& region);
+    // Pops the region of the current render target, along with anything pushed after it, and
+    // goes back to rendering into the previous target or the window.
+    static void popTarget();
+    // The window position the current render target starts at. Zero when rendering to the
+    // window.
+    static glm::vec2 targetOrigin();
+
     static void applyBase();
 
     static Rectangle currentViewport();
     static Rectangle currentScissor();
 
+    // The callback is called right before the viewport or scissor is changed, so that
+    // batching renderers can flush whatever they have recorded for the current region.
+    [[nodiscard]]
+    static fiv::ID subscribeChange(ChangeCallback callback) {
+        return changeCallbacks.push(callback);
+    }
+    static void unsubscribeChange(fiv::ID id) { changeCallbacks.remove(id); }
+
+    // The callback is called right before rendering is redirected to another render target.
+    // Renderers that batch across region changes must flush then.
+    [[nodiscard]]
+    static fiv::ID subscribeTargetChange(ChangeCallback callback) {
+        return targetCallbacks.push(callback);
+    }
+    static void unsubscribeTargetChange(fiv::ID id) { targetCallbacks.remove(id); }
+    // Calls the target change callbacks without changing the target, so that renderers that
+    // batch across region changes draw what they recorded before what is drawn next
+    static void flushBatches() { notifyTargetChange(); }
+
 private:
+    struct TargetEntry {
+        const RenderTarget* target;
+        glm::vec2 origin;
+        // The size of the region stack below the region of the target
+        size_t stackSize;
+    };
+
+    static void notifyChange();
+    static void notifyTargetChange();
+
+    // Apply the regions to OpenGL, relative to the current render target
+    static void applyViewport(const Rectangle& region);
+    static void applyScissor(const Rectangle& region);
+
     static inline std::vector<std::pair<Rectangle, Mode>> stack;
+    static inline std::vector<TargetEntry> targets;
+    static inline fiv::Vector<ChangeCallback> changeCallbacks;
+    static inline fiv::Vector<ChangeCallback> targetCallbacks;
 
 public:
     static inline Rectangle base{0, 0, 1, 1};
@@ -1,4 +1,5 @@
 #include "SSBO.h"
+#include "State.h"
 
 namespace fc::gl {
 SSBO::SSBO(const SSBOLayout& ssboLayout) {
@@ -32,7 +33,7 @@ void SSBO::setData(const void* data, GLuint index) {
 }
 
 void SSBO::bindIndex(GLuint index) const {
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, m_Handle);
+    State::bindBufferBase(GL_SHADER_STORAGE_BUFFER, index, m_Handle);
 }
 
 bool SSBO::resizeLast(GLuint count) {
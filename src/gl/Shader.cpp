@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "State.h"
 #include "core/StringUtils.h"
 #include <algorithm>
 #include <fstream>
@@ -52,6 +53,7 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
 
 Shader::~Shader() {
     if (m_Handle != 0) {
+        State::forgetProgram(m_Handle);
         glDeleteProgram(m_Handle);
     }
 }
@@ -144,6 +146,7 @@ void Shader::link() {
     }
 
     glValidateProgram(m_Handle);
+    readUniformLocations();
 
     for (const GLuint& shader : m_Stages) {
         glDeleteShader(shader);
@@ -151,11 +154,15 @@ void Shader::link() {
 }
 
 void Shader::bind() const {
-    glUseProgram(m_Handle);
+    State::useProgram(m_Handle);
 }
 
 void Shader::unbind() const {
-    glUseProgram(0);
+    State::useProgram(0);
+}
+
+Uniform Shader::uniform(const std::string& name, bool warn) const {
+    return Uniform(m_Handle, getUniformLocation(name, warn));
 }
 
 void Shader::setUniformSamplers(const std::string& name, GLsizei count, const GLint* value) const {
@@ -305,7 +312,7 @@ void Shader::setUniformMat4x3f(const std::string& name, const glm::mat4x3& matri
     glUniformMatrix4x3fv(getUniformLocation(name), 1, transpose, &matrix[0][0]);
 }
 
-bool Shader::uniformExists(const std::string& name) {
+bool Shader::uniformExists(const std::string& name) const {
     return getUniformLocation(name, false) != -1;
 }
 
@@ -313,16 +320,54 @@ GLuint Shader::handle() const {
     return m_Handle;
 }
 
+void Shader::readUniformLocations() {
+    m_UniformLocations.clear();
+
+    GLint count = 0;
+    GLint maxNameLength = 0;
+    glGetProgramInterfaceiv(m_Handle, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+    glGetProgramInterfaceiv(m_Handle, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+    std::string name(std::max(maxNameLength, 1), '\0');
+    const GLenum properties[] = {GL_LOCATION, GL_ARRAY_SIZE};
+    for (GLint i = 0; i < count; i++) {
+        GLint values[] = {-1, 1};
+        glGetProgramResourceiv(m_Handle, GL_UNIFORM, i, 2, properties, 2, nullptr, values);
+        const GLint location = values[0];
+        const GLint arraySize = values[1];
+        // Uniforms in blocks have no location
+        if (location == -1)
+            continue;
+
+        GLsizei length = 0;
+        glGetProgramResourceName(m_Handle, GL_UNIFORM, i, static_cast<GLsizei>(name.size()),
+                                 &length, name.data());
+        std::string uniformName(name.data(), length);
+        m_UniformLocations[uniformName] = location;
+
+        // Arrays are reported as "name[0]", but are usually referred to by their name. Their
+        // other elements are not reported, so they are looked up here once.
+        if (uniformName.ends_with("[0]")) {
+            uniformName.resize(uniformName.size() - 3);
+            m_UniformLocations[uniformName] = location;
+
+            for (GLint element = 1; element < arraySize; element++) {
+                const std::string elementName = uniformName + "[" + std::to_string(element) + "]";
+                m_UniformLocations[elementName]
+                    = glGetUniformLocation(m_Handle, elementName.c_str());
+            }
+        }
+    }
+}
+
 GLint Shader::getUniformLocation(const std::string& name, bool warn) const {
-    if (m_UniformLocations.find(name) != m_UniformLocations.end())
-        return m_UniformLocations[name];
-    GLint location = glGetUniformLocation(m_Handle, name.c_str());
-    if (location == -1 && warn) {
+    auto it = m_UniformLocations.find(name);
+    if (it != m_UniformLocations.end())
+        return it->second;
+    if (warn) {
         std::cout << "Warning: uniform " << name << " does not exist in shader: " << m_Handle
                   << std::endl;
-        return -1;
     }
-    m_UniformLocations[name] = location;
-    return location;
+    return -1;
 }
 } // namespace fc::gl
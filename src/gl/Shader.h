@@ -1,5 +1,6 @@
 #pragma once
 #include "OpenGL.h"
+#include "Uniform.h"
 #include "glm/glm.hpp"
 #include <string>
 #include <unordered_map>
@@ -13,7 +14,9 @@ class Shader {
 private:
     GLuint m_Handle;
     std::vector<GLuint> m_Stages;
-    mutable std::unordered_map<std::string, int> m_UniformLocations;
+    // Every active uniform of the program and every element of its arrays, read when it is
+    // linked
+    std::unordered_map<std::string, GLint> m_UniformLocations;
 
 public:
     Shader();
@@ -35,6 +38,11 @@ public:
     void bind() const;
     void unbind() const;
 
+    // The handle of a uniform, to be looked up once after linking and kept. Setting it through
+    // the handle is cheaper than through the setters taking a name, which search for it on
+    // every call. Arrays can be named with or without "[0]".
+    Uniform uniform(const std::string& name, bool warn = true) const;
+
     void setUniformSamplers(const std::string& name, GLsizei count, const GLint* value) const;
 
     void setUniform1f(const std::string& name, GLfloat v0) const;
@@ -87,11 +95,14 @@ public:
     void setUniformMat4x3f(const std::string& name, const glm::mat4x3& matrix,
                            const GLboolean transpose = GL_FALSE) const;
 
-    bool uniformExists(const std::string& name);
+    bool uniformExists(const std::string& name) const;
 
     GLuint handle() const;
 
 private:
+    // Reads the names and locations of the active uniforms of the linked program
+    void readUniformLocations();
+
     GLint getUniformLocation(const std::string& name, bool warn = true) const;
 };
 
@@ -0,0 +1,245 @@
+#include "State.h"
+
+fc::gl::State::Shadow fc::gl::State::shadow;
+fc::gl::State::Counters fc::gl::State::callCounters;
+
+int fc::gl::State::capabilityIndex(GLenum capability) {
+    switch (capability) {
+    case GL_BLEND:
+        return 0;
+    case GL_CULL_FACE:
+        return 1;
+    case GL_DEPTH_TEST:
+        return 2;
+    case GL_SCISSOR_TEST:
+        return 3;
+    case GL_STENCIL_TEST:
+        return 4;
+    case GL_MULTISAMPLE:
+        return 5;
+    default:
+        return -1;
+    }
+}
+
+int fc::gl::State::bufferTargetIndex(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return 0;
+    case GL_ELEMENT_ARRAY_BUFFER:
+        return 1;
+    case GL_UNIFORM_BUFFER:
+        return 2;
+    case GL_SHADER_STORAGE_BUFFER:
+        return 3;
+    case GL_DRAW_INDIRECT_BUFFER:
+        return 4;
+    case GL_COPY_READ_BUFFER:
+        return 5;
+    case GL_COPY_WRITE_BUFFER:
+        return 6;
+    case GL_PIXEL_UNPACK_BUFFER:
+        return 7;
+    default:
+        return -1;
+    }
+}
+
+int fc::gl::State::indexedTargetIndex(GLenum target) {
+    switch (target) {
+    case GL_UNIFORM_BUFFER:
+        return 0;
+    case GL_SHADER_STORAGE_BUFFER:
+        return 1;
+    default:
+        return -1;
+    }
+}
+
+int fc::gl::State::textureTargetIndex(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D:
+        return 0;
+    case GL_TEXTURE_2D_ARRAY:
+        return 1;
+    case GL_TEXTURE_3D:
+        return 2;
+    case GL_TEXTURE_CUBE_MAP:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+bool fc::gl::State::change(GLuint& shadowed, GLuint value) {
+    if (shadowed == value) {
+        callCounters.skipped++;
+        return false;
+    }
+    shadowed = value;
+    callCounters.issued++;
+    return true;
+}
+
+void fc::gl::State::setCapability(GLenum capability, bool enabled) {
+    const int index = capabilityIndex(capability);
+    if (index < 0) {
+        passThrough();
+    } else if (!change(shadow.capabilities[index], enabled ? GL_TRUE : GL_FALSE)) {
+        return;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void fc::gl::State::enable(GLenum capability) {
+    setCapability(capability, true);
+}
+
+void fc::gl::State::disable(GLenum capability) {
+    setCapability(capability, false);
+}
+
+void fc::gl::State::blendFunc(GLenum source, GLenum destination) {
+    blendFuncSeparate(source, destination, source, destination);
+}
+
+void fc::gl::State::blendFuncSeparate(GLenum colorSource, GLenum colorDestination,
+                                      GLenum alphaSource, GLenum alphaDestination) {
+    if (shadow.blendSource == colorSource && shadow.blendDestination == colorDestination
+        && shadow.blendAlphaSource == alphaSource
+        && shadow.blendAlphaDestination == alphaDestination) {
+        callCounters.skipped++;
+        return;
+    }
+    shadow.blendSource = colorSource;
+    shadow.blendDestination = colorDestination;
+    shadow.blendAlphaSource = alphaSource;
+    shadow.blendAlphaDestination = alphaDestination;
+    callCounters.issued++;
+    glBlendFuncSeparate(colorSource, colorDestination, alphaSource, alphaDestination);
+}
+
+void fc::gl::State::cullFace(GLenum mode) {
+    if (change(shadow.cullMode, mode))
+        glCullFace(mode);
+}
+
+void fc::gl::State::depthFunc(GLenum function) {
+    if (change(shadow.depthFunction, function))
+        glDepthFunc(function);
+}
+
+void fc::gl::State::useProgram(GLuint program) {
+    if (change(shadow.program, program))
+        glUseProgram(program);
+}
+
+void fc::gl::State::bindVertexArray(GLuint vertexArray) {
+    if (!change(shadow.vertexArray, vertexArray))
+        return;
+
+    glBindVertexArray(vertexArray);
+    // The element buffer binding is part of the vertex array
+    shadow.buffers[bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+}
+
+void fc::gl::State::bindBuffer(GLenum target, GLuint buffer) {
+    const int index = bufferTargetIndex(target);
+    if (index < 0) {
+        passThrough();
+    } else if (!change(shadow.buffers[index], buffer)) {
+        return;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void fc::gl::State::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    const int targetIndex = indexedTargetIndex(target);
+    if (targetIndex < 0 || index >= INDEXED_BINDING_COUNT) {
+        passThrough();
+    } else if (!change(shadow.indexedBuffers[targetIndex][index], buffer)) {
+        return;
+    }
+    glBindBufferBase(target, index, buffer);
+
+    // Binding to an indexed target binds to the generic target as well
+    const int genericIndex = bufferTargetIndex(target);
+    if (genericIndex >= 0) {
+        shadow.buffers[genericIndex] = buffer;
+    }
+}
+
+void fc::gl::State::activeTexture(GLuint unit) {
+    if (unit >= TEXTURE_UNIT_COUNT) {
+        passThrough();
+        shadow.activeUnit = unit;
+    } else if (!change(shadow.activeUnit, unit)) {
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void fc::gl::State::bindTexture(GLenum target, GLuint texture) {
+    const int index = textureTargetIndex(target);
+    if (index < 0 || shadow.activeUnit >= TEXTURE_UNIT_COUNT) {
+        passThrough();
+    } else if (!change(shadow.textures[shadow.activeUnit][index], texture)) {
+        return;
+    }
+    glBindTexture(target, texture);
+}
+
+void fc::gl::State::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    // Skip changing the active unit as well if the texture is already bound
+    const int index = textureTargetIndex(target);
+    if (index >= 0 && unit < TEXTURE_UNIT_COUNT && shadow.textures[unit][index] == texture) {
+        callCounters.skipped++;
+        return;
+    }
+
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void fc::gl::State::forgetProgram(GLuint program) {
+    if (shadow.program == program)
+        shadow.program = UNKNOWN;
+}
+
+void fc::gl::State::forgetVertexArray(GLuint vertexArray) {
+    if (shadow.vertexArray == vertexArray) {
+        shadow.vertexArray = UNKNOWN;
+        shadow.buffers[bufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void fc::gl::State::forgetBuffer(GLuint buffer) {
+    for (GLuint& bound : shadow.buffers) {
+        if (bound == buffer)
+            bound = UNKNOWN;
+    }
+    for (auto& bindings : shadow.indexedBuffers) {
+        for (GLuint& bound : bindings) {
+            if (bound == buffer)
+                bound = UNKNOWN;
+        }
+    }
+}
+
+void fc::gl::State::forgetTexture(GLuint texture) {
+    for (auto& unit : shadow.textures) {
+        for (GLuint& bound : unit) {
+            if (bound == texture)
+                bound = UNKNOWN;
+        }
+    }
+}
+
+void fc::gl::State::invalidate() {
+    shadow = Shadow();
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include "OpenGL.h"
+#include <array>
+#include <cstdint>
+
+namespace fc::gl {
+
+// Shadows the OpenGL state that is set the most: capabilities, blending, culling, depth
+// function, the bound program, vertex array, buffers and textures. Setting a state that is
+// already in effect is skipped instead of reaching the driver. The wrappers in fc::gl and the
+// renderers go through it, so state set directly with OpenGL, for example by another library,
+// must be followed by a call to invalidate().
+class State {
+public:
+    struct Counters {
+        // Calls that reached OpenGL
+        uint64_t issued = 0;
+        // Calls that were skipped because the state was already set
+        uint64_t skipped = 0;
+    };
+
+public:
+    static void enable(GLenum capability);
+    static void disable(GLenum capability);
+
+    static void blendFunc(GLenum source, GLenum destination);
+    // Like blendFunc, with other factors for the alpha channel than for the color channels
+    static void blendFuncSeparate(GLenum colorSource, GLenum colorDestination,
+                                  GLenum alphaSource, GLenum alphaDestination);
+    static void cullFace(GLenum mode);
+    static void depthFunc(GLenum function);
+
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vertexArray);
+    static void bindBuffer(GLenum target, GLuint buffer);
+    static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+    static void activeTexture(GLuint unit);
+    // Binds the texture to the active texture unit
+    static void bindTexture(GLenum target, GLuint texture);
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    // OpenGL unbinds deleted objects and may reuse their names, so these must be called before
+    // an object is deleted
+    static void forgetProgram(GLuint program);
+    static void forgetVertexArray(GLuint vertexArray);
+    static void forgetBuffer(GLuint buffer);
+    static void forgetTexture(GLuint texture);
+
+    // Forgets all shadowed state, so that the next call of every kind reaches OpenGL
+    static void invalidate();
+
+    static const Counters& counters() { return callCounters; }
+    static void resetCounters() { callCounters = Counters(); }
+
+private:
+    // Marks state that is not known, which is the case until it is first set
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+
+    static constexpr size_t CAPABILITY_COUNT = 6;
+    static constexpr size_t BUFFER_TARGET_COUNT = 8;
+    static constexpr size_t INDEXED_TARGET_COUNT = 2;
+    static constexpr size_t INDEXED_BINDING_COUNT = 16;
+    static constexpr size_t TEXTURE_UNIT_COUNT = 32;
+    static constexpr size_t TEXTURE_TARGET_COUNT = 4;
+
+    // The index of the target in the shadowed state, or -1 if it is not shadowed
+    static int capabilityIndex(GLenum capability);
+    static int bufferTargetIndex(GLenum target);
+    static int indexedTargetIndex(GLenum target);
+    static int textureTargetIndex(GLenum target);
+
+    // Updates the shadowed value. Returns whether the call has to reach OpenGL.
+    static bool change(GLuint& shadowed, GLuint value);
+    // Counts a call to state that is not shadowed
+    static void passThrough() { callCounters.issued++; }
+
+    static void setCapability(GLenum capability, bool enabled);
+
+    template <size_t N> static constexpr std::array<GLuint, N> unknownArray() {
+        std::array<GLuint, N> array{};
+        array.fill(UNKNOWN);
+        return array;
+    }
+
+    template <size_t N, size_t M>
+    static constexpr std::array<std::array<GLuint, M>, N> unknownArray() {
+        std::array<std::array<GLuint, M>, N> array{};
+        array.fill(unknownArray<M>());
+        return array;
+    }
+
+    struct Shadow {
+        std::array<GLuint, CAPABILITY_COUNT> capabilities = unknownArray<CAPABILITY_COUNT>();
+        GLuint blendSource = UNKNOWN;
+        GLuint blendDestination = UNKNOWN;
+        GLuint blendAlphaSource = UNKNOWN;
+        GLuint blendAlphaDestination = UNKNOWN;
+        GLuint cullMode = UNKNOWN;
+        GLuint depthFunction = UNKNOWN;
+
+        GLuint program = UNKNOWN;
+        GLuint vertexArray = UNKNOWN;
+        std::array<GLuint, BUFFER_TARGET_COUNT> buffers = unknownArray<BUFFER_TARGET_COUNT>();
+        std::array<std::array<GLuint, INDEXED_BINDING_COUNT>, INDEXED_TARGET_COUNT> indexedBuffers
+            = unknownArray<INDEXED_TARGET_COUNT, INDEXED_BINDING_COUNT>();
+
+        GLuint activeUnit = UNKNOWN;
+        std::array<std::array<GLuint, TEXTURE_TARGET_COUNT>, TEXTURE_UNIT_COUNT> textures
+            = unknownArray<TEXTURE_UNIT_COUNT, TEXTURE_TARGET_COUNT>();
+    };
+
+    static Shadow shadow;
+    static Counters callCounters;
+};
+
+} // namespace fc::gl
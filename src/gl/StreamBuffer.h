@@ -0,0 +1,183 @@
+#pragma once
+#include "OpenGL.h"
+#include "State.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace fc::gl {
+
+// A buffer for data that is rewritten every frame. The storage is allocated once as immutable
+// storage and stays persistently mapped, so the CPU writes straight into memory the
+// GPU reads from. The buffer is split into regions that are used like a ring: a fence is
+// placed when a region is left, and waited on before the region is written to again.
+template <GLenum t_Type> class StreamBuffer {
+public:
+    static constexpr uint32_t REGION_COUNT = 3;
+
+    struct Allocation {
+        void* data;
+        // The offset in bytes from the start of the buffer
+        GLintptr offset;
+    };
+
+private:
+    static constexpr GLbitfield MAP_FLAGS
+        = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    GLuint m_Handle = 0;
+    uint8_t* m_Mapped = nullptr;
+
+    GLsizeiptr m_RegionSize = 0;
+    std::array<GLsync, REGION_COUNT> m_Fences{};
+    uint32_t m_Region = 0;
+    // The offset of the next write, relative to the start of the current region
+    GLsizeiptr m_Head = 0;
+
+public:
+    StreamBuffer(GLsizeiptr regionSize = 0) {
+        if (regionSize > 0) {
+            create(regionSize);
+        }
+    }
+
+    ~StreamBuffer() { destroy(); }
+
+    // move assignment
+    StreamBuffer& operator=(StreamBuffer&& other) {
+        std::swap(m_Handle, other.m_Handle);
+        std::swap(m_Mapped, other.m_Mapped);
+        std::swap(m_RegionSize, other.m_RegionSize);
+        std::swap(m_Fences, other.m_Fences);
+        std::swap(m_Region, other.m_Region);
+        std::swap(m_Head, other.m_Head);
+        return *this;
+    }
+
+    // move constructor
+    StreamBuffer(StreamBuffer&& other)
+        : m_Handle(other.m_Handle),
+          m_Mapped(other.m_Mapped),
+          m_RegionSize(other.m_RegionSize),
+          m_Fences(other.m_Fences),
+          m_Region(other.m_Region),
+          m_Head(other.m_Head) {
+        other.m_Handle = 0;
+        other.m_Mapped = nullptr;
+        other.m_Fences = {};
+    }
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    inline void bind() const { State::bindBuffer(t_Type, m_Handle); }
+
+    inline void unbind() const { State::bindBuffer(t_Type, 0); }
+
+    // Makes sure a single write of the given size fits in one region. The regions grow
+    // geometrically. Returns true if the storage was recreated, in which case the handle has
+    // changed and vertex arrays referring to the buffer must be set up again.
+    bool reserve(GLsizeiptr size, GLsizeiptr alignment = 1) {
+        const GLsizeiptr required = size + alignment - 1;
+        if (required <= m_RegionSize)
+            return false;
+
+        const GLsizeiptr regionSize = std::max(required, m_RegionSize * 2);
+        destroy();
+        create(regionSize);
+        return true;
+    }
+
+    // Returns memory for size bytes, starting at an offset that is a multiple of alignment.
+    // The memory is only valid until the next call to allocate or write.
+    Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 1) {
+        if (size + alignment - 1 > m_RegionSize) {
+            throw std::length_error("StreamBuffer region is too small for the allocation. "
+                                    "Call reserve() before allocating.");
+        }
+
+        GLintptr offset = alignUp(regionStart() + m_Head, alignment);
+        if (offset + size > regionStart() + m_RegionSize) {
+            nextRegion();
+            offset = alignUp(regionStart(), alignment);
+        }
+
+        m_Head = offset + size - regionStart();
+        return {m_Mapped + offset, offset};
+    }
+
+    // Copies the data into the buffer and returns its offset in bytes.
+    GLintptr write(const void* data, GLsizeiptr size, GLsizeiptr alignment = 1) {
+        Allocation allocation = allocate(size, alignment);
+        std::memcpy(allocation.data, data, size);
+        return allocation.offset;
+    }
+
+    inline GLuint getHandle() const { return m_Handle; }
+    inline GLsizeiptr getRegionSize() const { return m_RegionSize; }
+
+private:
+    inline GLintptr regionStart() const { return m_Region * m_RegionSize; }
+
+    static GLintptr alignUp(GLintptr offset, GLsizeiptr alignment) {
+        return ((offset + alignment - 1) / alignment) * alignment;
+    }
+
+    // Fences the current region and moves on to the next one, waiting for the GPU to be done
+    // reading from it if needed.
+    void nextRegion() {
+        m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        m_Region = (m_Region + 1) % REGION_COUNT;
+        m_Head = 0;
+
+        GLsync& fence = m_Fences[m_Region];
+        if (fence == nullptr)
+            return;
+
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(fence, 0, 1000000);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    void create(GLsizeiptr regionSize) {
+        m_RegionSize = regionSize;
+        m_Region = 0;
+        m_Head = 0;
+
+        // Direct state access is used so that recreating an index buffer does not change the
+        // element buffer of whatever vertex array happens to be bound
+        glCreateBuffers(1, &m_Handle);
+        glNamedBufferStorage(m_Handle, m_RegionSize * REGION_COUNT, nullptr, MAP_FLAGS);
+        m_Mapped = static_cast<uint8_t*>(
+            glMapNamedBufferRange(m_Handle, 0, m_RegionSize * REGION_COUNT, MAP_FLAGS));
+    }
+
+    void destroy() {
+        for (GLsync& fence : m_Fences) {
+            if (fence != nullptr) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        // Deleting a buffer also unmaps it
+        if (m_Handle != 0) {
+            State::forgetBuffer(m_Handle);
+            glDeleteBuffers(1, &m_Handle);
+        }
+        m_Handle = 0;
+        m_Mapped = nullptr;
+        m_RegionSize = 0;
+    }
+};
+
+using StreamVertexBuffer = StreamBuffer<GL_ARRAY_BUFFER>;
+using StreamIndexBuffer = StreamBuffer<GL_ELEMENT_ARRAY_BUFFER>;
+
+} // namespace fc::gl
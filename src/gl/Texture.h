@@ -1,5 +1,6 @@
 #pragma once
 #include "OpenGL.h"
+#include "State.h"
 #include "glm/glm.hpp"
 #include <string>
 
@@ -14,6 +15,7 @@ public:
 
     ~Texture() {
         if (m_Handle != 0) {
+            State::forgetTexture(m_Handle);
             glDeleteTextures(1, &m_Handle);
         }
     }
@@ -33,11 +35,10 @@ public:
     Texture& operator=(const Texture&) = delete;
 
     void bind(size_t slot) const {
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(slot));
-        glBindTexture(Dimension, m_Handle);
+        State::bindTexture(static_cast<GLuint>(slot), Dimension, m_Handle);
     }
-    inline void bind() const { glBindTexture(Dimension, m_Handle); }
-    static void unbind() { glBindTexture(Dimension, 0); }
+    inline void bind() const { State::bindTexture(Dimension, m_Handle); }
+    static void unbind() { State::bindTexture(Dimension, 0); }
 
     inline GLuint getHandle() const { return m_Handle; }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Texture.h"
+#include "res/Image.h"
 
 namespace fc::gl {
 
@@ -13,11 +14,16 @@ private:
 public:
     Texture2D();
     Texture2D(const std::string& path, bool blurred);
+    // Uploads an image that was decoded beforehand, for example on another thread
+    Texture2D(const res::Image& image, bool blurred);
     Texture2D(GLint textureFormat, GLsizei width, GLsizei height, GLenum dataFormat,
               GLenum dataType, const void* data);
 
     void setData(GLint textureFormat, GLsizei width, GLsizei height, GLenum dataFormat,
                  GLenum dataType, const void* data);
+    // Replaces the contents with the image and its mipmaps. Everything that uses the texture
+    // sees the new image, so a placeholder can be filled in once the image is decoded.
+    void setImage(const res::Image& image);
 
     inline int width() const { return m_Width; }
     inline int height() const { return m_Height; }
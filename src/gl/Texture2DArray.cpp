@@ -0,0 +1,118 @@
+#include "Texture2DArray.h"
+#include "res/Image.h"
+#include <algorithm>
+#include <stdexcept>
+
+fc::gl::Texture2DArray::Texture2DArray(bool blurred) {
+    if (blurred) {
+        m_MinMagFilter = GL_LINEAR;
+    } else {
+        // Sharp
+        m_MinMagFilter = GL_NEAREST;
+    }
+}
+
+fc::gl::Texture2DArray::Texture2DArray(GLsizei width, GLsizei height, bool blurred)
+    : Texture2DArray(blurred) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Texture2DArray layers must have a non-zero size");
+    }
+    m_Width = width;
+    m_Height = height;
+}
+
+uint32_t fc::gl::Texture2DArray::addLayer(GLsizei width, GLsizei height, const void* data) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Texture2DArray layers must have a non-zero size");
+    }
+
+    if (m_Width == 0) {
+        m_Width = width;
+        m_Height = height;
+    }
+
+    if (width != m_Width || height != m_Height) {
+        throw std::invalid_argument("Texture2DArray layers must all have the same size. Expected "
+                                    + std::to_string(m_Width) + "x" + std::to_string(m_Height)
+                                    + ", got " + std::to_string(width) + "x"
+                                    + std::to_string(height));
+    }
+
+    reserve(m_Layers + 1);
+
+    glTextureSubImage3D(m_Handle, 0, 0, 0, m_Layers, m_Width, m_Height, 1, GL_RGBA,
+                        GL_UNSIGNED_BYTE, data);
+
+    return static_cast<uint32_t>(m_Layers++);
+}
+
+uint32_t fc::gl::Texture2DArray::addLayer(const std::string& path) {
+    const res::Image image(path);
+    if (!image.valid()) {
+        throw std::invalid_argument("Error loading texture: " + image.error());
+    }
+    return addLayer(image.width(), image.height(), image.pixels());
+}
+
+uint32_t fc::gl::Texture2DArray::addEmptyLayer() {
+    if (m_Width == 0) {
+        throw std::logic_error("Can not add an empty layer before the size of the layers is known");
+    }
+
+    reserve(m_Layers + 1);
+
+    const GLuint transparent = 0;
+    glClearTexSubImage(m_Handle, 0, 0, 0, m_Layers, m_Width, m_Height, 1, GL_RGBA,
+                       GL_UNSIGNED_BYTE, &transparent);
+
+    return static_cast<uint32_t>(m_Layers++);
+}
+
+void fc::gl::Texture2DArray::setSubImage(uint32_t layer, GLint x, GLint y, GLsizei width,
+                                         GLsizei height, const void* data) {
+    glTextureSubImage3D(m_Handle, 0, x, y, static_cast<GLint>(layer), width, height, 1, GL_RGBA,
+                        GL_UNSIGNED_BYTE, data);
+}
+
+void fc::gl::Texture2DArray::reserve(GLsizei layerCount) {
+    // The size of the layers is not known until the first one is added
+    if (layerCount <= m_Capacity || m_Width == 0)
+        return;
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (layerCount > maxLayers) {
+        throw std::length_error("Texture2DArray can not hold more than "
+                                + std::to_string(maxLayers) + " layers");
+    }
+
+    grow(std::min(std::max({layerCount, m_Capacity * 2, 16}), maxLayers));
+}
+
+void fc::gl::Texture2DArray::grow(GLsizei capacity) {
+    // Immutable storage can not be resized, so the layers are copied into a new texture
+    GLuint handle = 0;
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &handle);
+    glTextureStorage3D(handle, 1, GL_RGBA8, m_Width, m_Height, capacity);
+
+    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, m_MinMagFilter);
+    glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, m_MinMagFilter);
+    glTextureParameteri(handle, GL_TEXTURE_WRAP_S, m_WrapMode);
+    glTextureParameteri(handle, GL_TEXTURE_WRAP_T, m_WrapMode);
+
+    if (m_Layers > 0) {
+        glCopyImageSubData(m_Handle, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, handle, GL_TEXTURE_2D_ARRAY,
+                           0, 0, 0, 0, m_Width, m_Height, m_Layers);
+    }
+
+    if (m_Handle != 0) {
+        State::forgetTexture(m_Handle);
+        glDeleteTextures(1, &m_Handle);
+    }
+    m_Handle = handle;
+    m_Capacity = capacity;
+}
+
+glm::uvec3 fc::gl::Texture2DArray::size() const {
+    return {m_Width, m_Height, m_Layers};
+}
\ No newline at end of file
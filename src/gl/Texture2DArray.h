@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Texture.h"
+
+namespace fc::gl {
+
+// An array of same-sized 2D images that can all be sampled through a single texture unit.
+// The first layer decides the size of every layer. Storage grows geometrically as layers are
+// added, up to GL_MAX_ARRAY_TEXTURE_LAYERS.
+class Texture2DArray : public Texture<GL_TEXTURE_2D_ARRAY> {
+private:
+    GLsizei m_Width = 0, m_Height = 0;
+    GLsizei m_Layers = 0;
+    GLsizei m_Capacity = 0;
+    GLenum m_WrapMode = GL_CLAMP_TO_EDGE;
+    GLenum m_MinMagFilter = GL_LINEAR;
+
+public:
+    Texture2DArray(bool blurred = false);
+    // Creates an array where every layer has the given size
+    Texture2DArray(GLsizei width, GLsizei height, bool blurred = false);
+
+    // Adds an image with RGBA8 pixels and returns its layer
+    uint32_t addLayer(GLsizei width, GLsizei height, const void* data);
+    // Loads an image from file and returns its layer
+    uint32_t addLayer(const std::string& path);
+    // Adds a transparent layer and returns it. Requires the size of the layers to be known.
+    uint32_t addEmptyLayer();
+
+    // Replaces a part of a layer with RGBA8 pixels
+    void setSubImage(uint32_t layer, GLint x, GLint y, GLsizei width, GLsizei height,
+                     const void* data);
+
+    // Makes sure there is storage for the given amount of layers. Has no effect before the
+    // first layer is added.
+    void reserve(GLsizei layerCount);
+
+    inline int width() const { return m_Width; }
+    inline int height() const { return m_Height; }
+    inline int layers() const { return m_Layers; }
+
+    glm::uvec3 size() const override;
+
+private:
+    void grow(GLsizei capacity);
+};
+} // namespace fc::gl
\ No newline at end of file
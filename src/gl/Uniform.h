@@ -0,0 +1,68 @@
+#pragma once
+#include "OpenGL.h"
+#include "glm/glm.hpp"
+
+namespace fc::gl {
+
+// A uniform of a linked shader program, looked up once with Shader::uniform. The setters go
+// straight to the program with glProgramUniform*, so they neither look up a name nor require
+// the program to be bound. Setting a uniform that does not exist in the program does nothing.
+class Uniform {
+private:
+    GLuint m_Program = 0;
+    GLint m_Location = -1;
+
+public:
+    Uniform() = default;
+    Uniform(GLuint program, GLint location) : m_Program(program), m_Location(location) {}
+
+    bool exists() const { return m_Location != -1; }
+    GLint location() const { return m_Location; }
+
+    void set(GLfloat v) const { glProgramUniform1f(m_Program, m_Location, v); }
+    void set(const glm::vec2& v) const { glProgramUniform2f(m_Program, m_Location, v.x, v.y); }
+    void set(const glm::vec3& v) const {
+        glProgramUniform3f(m_Program, m_Location, v.x, v.y, v.z);
+    }
+    void set(const glm::vec4& v) const {
+        glProgramUniform4f(m_Program, m_Location, v.x, v.y, v.z, v.w);
+    }
+
+    void set(GLint v) const { glProgramUniform1i(m_Program, m_Location, v); }
+    void set(const glm::ivec2& v) const { glProgramUniform2i(m_Program, m_Location, v.x, v.y); }
+    void set(const glm::ivec3& v) const {
+        glProgramUniform3i(m_Program, m_Location, v.x, v.y, v.z);
+    }
+    void set(const glm::ivec4& v) const {
+        glProgramUniform4i(m_Program, m_Location, v.x, v.y, v.z, v.w);
+    }
+
+    void set(GLuint v) const { glProgramUniform1ui(m_Program, m_Location, v); }
+    void set(const glm::uvec2& v) const { glProgramUniform2ui(m_Program, m_Location, v.x, v.y); }
+    void set(const glm::uvec3& v) const {
+        glProgramUniform3ui(m_Program, m_Location, v.x, v.y, v.z);
+    }
+    void set(const glm::uvec4& v) const {
+        glProgramUniform4ui(m_Program, m_Location, v.x, v.y, v.z, v.w);
+    }
+
+    // Booleans are set as integers, like OpenGL expects
+    void set(bool v) const { glProgramUniform1i(m_Program, m_Location, v ? 1 : 0); }
+
+    void set(const glm::mat2& m) const {
+        glProgramUniformMatrix2fv(m_Program, m_Location, 1, GL_FALSE, &m[0][0]);
+    }
+    void set(const glm::mat3& m) const {
+        glProgramUniformMatrix3fv(m_Program, m_Location, 1, GL_FALSE, &m[0][0]);
+    }
+    void set(const glm::mat4& m) const {
+        glProgramUniformMatrix4fv(m_Program, m_Location, 1, GL_FALSE, &m[0][0]);
+    }
+
+    // Sets an array of samplers, starting from the first element of the array
+    void setSamplers(GLsizei count, const GLint* units) const {
+        glProgramUniform1iv(m_Program, m_Location, count, units);
+    }
+};
+
+} // namespace fc::gl
@@ -0,0 +1,15 @@
+#pragma once
+#include "Buffer.h"
+#include "State.h"
+
+namespace fc::gl {
+
+class UniformBuffer : public Buffer<GL_UNIFORM_BUFFER> {
+public:
+    // Associates this buffer with the uniform block that has the given binding point
+    void bindIndex(GLuint index) const {
+        State::bindBufferBase(GL_UNIFORM_BUFFER, index, m_Handle);
+    }
+};
+
+} // namespace fc::gl
@@ -1,4 +1,5 @@
 #include "VertexArray.h"
+#include "State.h"
 #include "VertexBufferLayout.h"
 
 namespace fc::gl {
@@ -9,6 +10,7 @@ VertexArray::VertexArray() {
 
 VertexArray::~VertexArray() {
     if (m_Handle != 0) {
+        State::forgetVertexArray(m_Handle);
         glDeleteVertexArrays(1, &m_Handle);
     }
 }
@@ -26,6 +28,31 @@ VertexArray::VertexArray(VertexArray&& other) {
 void VertexArray::addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) const {
     bind();
     vb.bind();
+    setAttributes(layout);
+}
+
+void VertexArray::addBuffer(const IndexBuffer& ib) const {
+    ib.bind();
+}
+
+void VertexArray::addBuffer(const StreamVertexBuffer& vb, const VertexBufferLayout& layout) const {
+    bind();
+    vb.bind();
+    setAttributes(layout);
+}
+
+void VertexArray::addBuffer(const StreamIndexBuffer& ib) const {
+    ib.bind();
+}
+
+void VertexArray::addInstanceBuffer(const StreamVertexBuffer& vb,
+                                    const VertexBufferLayout& layout) const {
+    bind();
+    vb.bind();
+    setAttributes(layout, 1);
+}
+
+void VertexArray::setAttributes(const VertexBufferLayout& layout, GLuint divisor) const {
     const auto& elements = layout.getElements();
     uint32_t offset = 0;
     for (GLuint i = 0; i < elements.size(); i++) {
@@ -38,20 +65,17 @@ void VertexArray::addBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
             glVertexAttribPointer(i, element.count, element.type, element.normalized,
                                   layout.getStride(), reinterpret_cast<const void*>(offset));
         }
+        glVertexAttribDivisor(i, divisor);
         offset += element.count * VertexBufferElement::sizeOfType(element.type);
     }
 }
 
-void VertexArray::addBuffer(const IndexBuffer& ib) const {
-    ib.bind();
-}
-
 void VertexArray::bind() const {
-    glBindVertexArray(m_Handle);
+    State::bindVertexArray(m_Handle);
 }
 
 void VertexArray::unbind() const {
-    glBindVertexArray(0);
+    State::bindVertexArray(0);
 }
 
 } // namespace fc::gl
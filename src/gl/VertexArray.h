@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IndexBuffer.h"
+#include "StreamBuffer.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 
@@ -24,9 +25,17 @@ public:
 
     void addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) const;
     void addBuffer(const IndexBuffer& ib) const;
+    void addBuffer(const StreamVertexBuffer& vb, const VertexBufferLayout& layout) const;
+    void addBuffer(const StreamIndexBuffer& ib) const;
+    // Adds a buffer whose attributes advance once per instance instead of once per vertex
+    void addInstanceBuffer(const StreamVertexBuffer& vb, const VertexBufferLayout& layout) const;
 
     void bind() const;
     void unbind() const;
+
+private:
+    // Sets up the attributes of the currently bound vertex buffer
+    void setAttributes(const VertexBufferLayout& layout, GLuint divisor = 0) const;
 };
 
 } // namespace fc::gl
\ No newline at end of file
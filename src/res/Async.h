@@ -0,0 +1,44 @@
+#pragma once
+#include <memory>
+#include <string>
+
+namespace fc::res {
+
+enum class LoadState { Loading, Ready, Failed };
+
+// The progress of an asynchronous load. It only changes on the context thread, when the upload
+// of the load runs.
+struct LoadStatus {
+    LoadState state = LoadState::Loading;
+    // Why the load failed, if it did
+    std::string error;
+};
+
+// The status of a resource that is already loaded
+inline std::shared_ptr<const LoadStatus> readyStatus() {
+    static const auto status = std::make_shared<const LoadStatus>(LoadStatus{LoadState::Ready, {}});
+    return status;
+}
+
+// A resource that is loaded in the background. The resource can be used right away: it is a
+// placeholder until the load is ready, and is then filled in place, so everything that holds
+// it sees the loaded data. A failed load leaves the placeholder.
+template <typename T> class Async {
+private:
+    std::shared_ptr<T> m_Resource;
+    std::shared_ptr<const LoadStatus> m_Status;
+
+public:
+    Async(std::shared_ptr<T> resource, std::shared_ptr<const LoadStatus> status)
+        : m_Resource(std::move(resource)), m_Status(std::move(status)) {}
+
+    const std::shared_ptr<T>& get() const { return m_Resource; }
+    operator const std::shared_ptr<T>&() const { return m_Resource; }
+    T* operator->() const { return m_Resource.get(); }
+
+    bool ready() const { return m_Status->state == LoadState::Ready; }
+    bool failed() const { return m_Status->state == LoadState::Failed; }
+    const std::string& error() const { return m_Status->error; }
+};
+
+} // namespace fc::res
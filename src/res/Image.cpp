@@ -0,0 +1,35 @@
+#include "Image.h"
+#include "stb_image.h"
+#include <cstdlib>
+
+fc::res::Image::Image(const std::string& path) {
+    // Only for this thread, since images may be decoded on several at once
+    stbi_set_flip_vertically_on_load_thread(1);
+    int bpp = 0;
+    stbi_uc* pixels = stbi_load(path.c_str(), &m_Width, &m_Height, &bpp, 4);
+
+    if (pixels == nullptr) {
+        m_Width = 0;
+        m_Height = 0;
+        m_Error = std::string(stbi_failure_reason()) + ". Path: " + path;
+        return;
+    }
+    m_Pixels = {pixels, stbi_image_free};
+}
+
+fc::res::Image fc::res::Image::filled(int width, int height, glm::u8vec4 color) {
+    Image image;
+    image.m_Width = width;
+    image.m_Height = height;
+
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    uint8_t* pixels = static_cast<uint8_t*>(std::malloc(pixelCount * 4));
+    for (size_t i = 0; i < pixelCount; i++) {
+        pixels[i * 4 + 0] = color.r;
+        pixels[i * 4 + 1] = color.g;
+        pixels[i * 4 + 2] = color.b;
+        pixels[i * 4 + 3] = color.a;
+    }
+    image.m_Pixels = {pixels, std::free};
+    return image;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "glm/ext/vector_uint4_sized.hpp"
+#include "glm/glm.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace fc::res {
+
+// The pixels of an image as 8-bit RGBA, with the bottom row first like OpenGL expects. Decoding
+// an image touches no OpenGL state, so it can be done on any thread and uploaded later.
+class Image {
+private:
+    int m_Width = 0;
+    int m_Height = 0;
+    std::unique_ptr<uint8_t, void (*)(void*)> m_Pixels{nullptr, nullptr};
+    // Why decoding failed, if it did
+    std::string m_Error;
+
+public:
+    Image() = default;
+    // Decodes the image file. An image that could not be decoded is not valid().
+    explicit Image(const std::string& path);
+
+    // An image of a single color
+    static Image filled(int width, int height, glm::u8vec4 color);
+
+    bool valid() const { return m_Pixels != nullptr; }
+    const std::string& error() const { return m_Error; }
+
+    int width() const { return m_Width; }
+    int height() const { return m_Height; }
+    const uint8_t* pixels() const { return m_Pixels.get(); }
+};
+
+} // namespace fc::res
@@ -0,0 +1,315 @@
+#include "MeshCache.h"
+#include "core/StringUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+namespace fc::res {
+
+namespace {
+
+// The cache is written in the byte order of the machine, so it is not meant to be shared
+// between machines. The version must be increased whenever the layout below, or the way models
+// are turned into it, changes.
+constexpr char MAGIC[4] = {'F', 'C', 'M', 'C'};
+constexpr uint32_t VERSION = 2;
+
+// The cache starts with the header, followed by the library, material and submesh tables, the
+// strings, and then the vertices and indices of all submeshes. The vertices start at a
+// multiple of BLOB_ALIGNMENT, so that they can be used from the mapping in place.
+struct Header {
+    char magic[4];
+    uint32_t version;
+    // A changed vertex layout makes the cache stale
+    uint32_t vertexSize;
+    uint32_t libraryCount;
+    uint32_t materialCount;
+    uint32_t subMeshCount;
+    uint64_t stringsSize;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+};
+
+// A string in the string section
+struct StringRecord {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct MaterialRecord {
+    glm::vec3 ambientColor;
+    glm::vec3 diffuseColor;
+    glm::vec3 specularColor;
+    glm::vec4 overrideColor;
+    float shininess;
+    float transparency;
+    StringRecord diffuseTexture;
+    StringRecord specularMap;
+    StringRecord normalMap;
+};
+
+struct SubMeshRecord {
+    uint64_t firstVertex;
+    uint64_t vertexCount;
+    uint64_t firstIndex;
+    uint64_t indexCount;
+    uint32_t material;
+    uint32_t padding;
+};
+
+constexpr size_t BLOB_ALIGNMENT = 16;
+
+size_t alignBlob(size_t offset) {
+    return (offset + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+}
+
+// Gathers the strings of the cache into the string section
+class StringWriter {
+private:
+    std::string m_Strings;
+
+public:
+    StringRecord add(const std::string& string) {
+        const StringRecord record{static_cast<uint32_t>(m_Strings.size()),
+                                  static_cast<uint32_t>(string.size())};
+        m_Strings += string;
+        return record;
+    }
+
+    const std::string& strings() const { return m_Strings; }
+};
+
+template <typename T> void writeArray(std::ofstream& file, std::span<const T> values) {
+    file.write(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+}
+
+// Reads the tables from the mapping, where they are not aligned for their types
+class Reader {
+private:
+    std::string_view m_Data;
+    size_t m_Offset = 0;
+
+public:
+    explicit Reader(std::string_view data) : m_Data(data) {}
+
+    template <typename T> bool read(std::span<T> values) {
+        if (values.size() > (m_Data.size() - m_Offset) / sizeof(T))
+            return false;
+        std::memcpy(values.data(), m_Data.data() + m_Offset, values.size_bytes());
+        m_Offset += values.size_bytes();
+        return true;
+    }
+
+    bool readBytes(uint64_t size, std::string_view& bytes) {
+        if (size > m_Data.size() - m_Offset)
+            return false;
+        bytes = m_Data.substr(m_Offset, size);
+        m_Offset += size;
+        return true;
+    }
+
+    size_t offset() const { return m_Offset; }
+};
+
+// Whether the cache was written after the source was last changed. Equal times count as stale,
+// since the source may have been changed again within the resolution of the clock.
+bool isNewer(const std::string& cachePath, const std::string& sourcePath) {
+    std::error_code error;
+    const auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+    if (error)
+        return false;
+    const auto cacheTime = std::filesystem::last_write_time(cachePath, error);
+    return !error && cacheTime > sourceTime;
+}
+} // namespace
+
+std::string meshCachePath(const std::string& modelPath) {
+    return modelPath + ".fcmesh";
+}
+
+bool writeMeshCache(const std::string& modelPath, const MeshCacheData& data) {
+    StringWriter strings;
+
+    std::vector<StringRecord> libraries;
+    for (const std::string& library : data.materialLibraries) {
+        libraries.push_back(strings.add(library));
+    }
+
+    std::vector<MaterialRecord> materials;
+    for (const MaterialSource& material : data.materials) {
+        const gl::Material& values = material.values;
+        materials.push_back({values.ambientColor, values.diffuseColor, values.specularColor,
+                             values.overrideColor, values.shininess, values.transparency,
+                             strings.add(material.diffuseTexture),
+                             strings.add(material.specularMap), strings.add(material.normalMap)});
+    }
+
+    std::vector<SubMeshRecord> subMeshes;
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    for (const MeshCacheSubMesh& subMesh : data.subMeshes) {
+        subMeshes.push_back({vertexCount, subMesh.vertices.size(), indexCount,
+                             subMesh.indices.size(), subMesh.material, 0});
+        vertexCount += subMesh.vertices.size();
+        indexCount += subMesh.indices.size();
+    }
+
+    const Header header{{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]},
+                        VERSION,
+                        sizeof(gl::Vertex3D),
+                        static_cast<uint32_t>(libraries.size()),
+                        static_cast<uint32_t>(materials.size()),
+                        static_cast<uint32_t>(subMeshes.size()),
+                        strings.strings().size(),
+                        vertexCount,
+                        indexCount};
+
+    // The cache is written next to its place first, so that a cache is never read half written.
+    // Every write gets its own file, since the same model may be loaded on several threads.
+    static std::atomic<uint32_t> writeCount = 0;
+    const std::string path = meshCachePath(modelPath);
+    const std::string temporaryPath
+        = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+          + "." + std::to_string(writeCount++) + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        writeArray<Header>(file, std::span(&header, 1));
+        writeArray<StringRecord>(file, libraries);
+        writeArray<MaterialRecord>(file, materials);
+        writeArray<SubMeshRecord>(file, subMeshes);
+        file.write(strings.strings().data(), strings.strings().size());
+
+        const size_t offset = static_cast<size_t>(file.tellp());
+        const char padding[BLOB_ALIGNMENT] = {};
+        file.write(padding, alignBlob(offset) - offset);
+
+        for (const MeshCacheSubMesh& subMesh : data.subMeshes) {
+            writeArray(file, subMesh.vertices);
+        }
+        for (const MeshCacheSubMesh& subMesh : data.subMeshes) {
+            writeArray(file, subMesh.indices);
+        }
+
+        if (!file) {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool readMeshCache(const std::string& modelPath, MappedFile& file, MeshCacheData& data) {
+    const std::string path = meshCachePath(modelPath);
+    if (!isNewer(path, modelPath))
+        return false;
+
+    file = MappedFile(path);
+    if (!file.isOpen())
+        return false;
+
+    Reader reader(file.view());
+    Header header;
+    if (!reader.read(std::span<Header>(&header, 1)) || std::memcmp(header.magic, MAGIC, 4) != 0
+        || header.version != VERSION || header.vertexSize != sizeof(gl::Vertex3D)) {
+        return false;
+    }
+
+    // The tables cannot be larger than the file
+    if (header.libraryCount > file.size() / sizeof(StringRecord)
+        || header.materialCount > file.size() / sizeof(MaterialRecord)
+        || header.subMeshCount > file.size() / sizeof(SubMeshRecord)) {
+        return false;
+    }
+
+    std::vector<StringRecord> libraries(header.libraryCount);
+    std::vector<MaterialRecord> materials(header.materialCount);
+    std::vector<SubMeshRecord> subMeshes(header.subMeshCount);
+    std::string_view strings;
+    if (!reader.read(std::span(libraries)) || !reader.read(std::span(materials))
+        || !reader.read(std::span(subMeshes)) || !reader.readBytes(header.stringsSize, strings)) {
+        return false;
+    }
+
+    const size_t vertexOffset = alignBlob(reader.offset());
+    if (vertexOffset > file.size()
+        || header.vertexCount > (file.size() - vertexOffset) / sizeof(gl::Vertex3D)) {
+        return false;
+    }
+    const size_t indexOffset = vertexOffset + header.vertexCount * sizeof(gl::Vertex3D);
+    if (header.indexCount > (file.size() - indexOffset) / sizeof(GLuint))
+        return false;
+
+    bool valid = true;
+    auto string = [&](const StringRecord& record) {
+        if (record.offset > strings.size() || record.size > strings.size() - record.offset) {
+            valid = false;
+            return std::string();
+        }
+        return std::string(strings.substr(record.offset, record.size));
+    };
+
+    data = MeshCacheData();
+    for (const StringRecord& library : libraries) {
+        data.materialLibraries.push_back(string(library));
+    }
+
+    for (const MaterialRecord& record : materials) {
+        MaterialSource& material = data.materials.emplace_back();
+        material.values.ambientColor = record.ambientColor;
+        material.values.diffuseColor = record.diffuseColor;
+        material.values.specularColor = record.specularColor;
+        material.values.overrideColor = record.overrideColor;
+        material.values.shininess = record.shininess;
+        material.values.transparency = record.transparency;
+        material.diffuseTexture = string(record.diffuseTexture);
+        material.specularMap = string(record.specularMap);
+        material.normalMap = string(record.normalMap);
+    }
+
+    const auto* vertices = reinterpret_cast<const gl::Vertex3D*>(file.view().data() + vertexOffset);
+    const auto* indices = reinterpret_cast<const GLuint*>(file.view().data() + indexOffset);
+    for (const SubMeshRecord& record : subMeshes) {
+        if (record.vertexCount > header.vertexCount
+            || record.firstVertex > header.vertexCount - record.vertexCount
+            || record.indexCount > header.indexCount
+            || record.firstIndex > header.indexCount - record.indexCount
+            || record.material >= data.materials.size()) {
+            return false;
+        }
+        data.subMeshes.push_back({{vertices + record.firstVertex, record.vertexCount},
+                                  {indices + record.firstIndex, record.indexCount},
+                                  record.material});
+
+        // An index past the vertices of its submesh would be read out of bounds when drawn
+        const bool indicesValid
+            = std::ranges::all_of(data.subMeshes.back().indices,
+                                  [&](GLuint index) { return index < record.vertexCount; });
+        if (!indicesValid)
+            return false;
+    }
+
+    // The material libraries are only known once the cache is read
+    for (const std::string& library : data.materialLibraries) {
+        if (!isNewer(path, utils::getPath(modelPath) + library))
+            return false;
+    }
+    return valid;
+}
+
+} // namespace fc::res
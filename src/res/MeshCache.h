@@ -0,0 +1,52 @@
+#pragma once
+#include "core/MappedFile.h"
+#include "gl/Material.h"
+#include "gl/OpenGL.h"
+#include "gl/Vertex3D.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fc::res {
+
+// A material of a model, with the paths of its textures relative to the directory of the
+// model. A path is empty if the material has no such texture. The textures of `values` are
+// not used.
+struct MaterialSource {
+    gl::Material values;
+    std::string diffuseTexture;
+    std::string specularMap;
+    std::string normalMap;
+};
+
+struct MeshCacheSubMesh {
+    std::span<const gl::Vertex3D> vertices;
+    std::span<const GLuint> indices;
+    // The index of the material in MeshCacheData::materials
+    uint32_t material;
+};
+
+// What the mesh cache of a model stores: the indexed vertices with their tangents, and the
+// materials, so that loading a cached model reads no text
+struct MeshCacheData {
+    // The .mtl files of the model, relative to its directory. The cache is stale if any of
+    // them is newer than it.
+    std::vector<std::string> materialLibraries;
+    std::vector<MaterialSource> materials;
+    std::vector<MeshCacheSubMesh> subMeshes;
+};
+
+// The file the cache of the model is stored in, next to the model
+std::string meshCachePath(const std::string& modelPath);
+
+// Writes the cache of the model. Returns false if it could not be written, in which case the
+// model is just loaded from its source again the next time.
+bool writeMeshCache(const std::string& modelPath, const MeshCacheData& data);
+
+// Reads the cache of the model, if it exists, has the current version and is newer than the
+// model and its material libraries. The vertices and indices point into `file`, which is
+// mapped by this function and must outlive them. Returns false if the cache cannot be used.
+bool readMeshCache(const std::string& modelPath, MappedFile& file, MeshCacheData& data);
+
+} // namespace fc::res
@@ -1,13 +1,40 @@
 #pragma once
+#include <memory>
 #include <string>
 
+#include "core/MappedFile.h"
+#include "core/Time.h"
+#include "gl/Model.h"
+#include "res/MeshCache.h"
+#include "res/ObjParser.h"
 #include "res/types.h"
 
 namespace fc {
 namespace res {
 class ResourceManager;
 
-ModelHandle loadModel(ResourceManager& res, const std::string& modelPath,
-                      float vertexSearchCoverage = 0.1);
+// What a model is created from: its mesh cache, or its parsed .obj file when the cache was
+// stale. The vertices and indices of `data` point into the cache or the parsed file.
+struct ModelData {
+    MappedFile cache;
+    ObjData obj;
+    MeshCacheData data;
+    time::Moment startTime = time::now();
+};
+
+// Reads a model from disk, parsing the .obj file and writing its mesh cache if the cache is
+// stale. Uses no OpenGL, so it can run on any thread.
+std::unique_ptr<ModelData> readModel(const std::string& modelPath);
+
+// Uploads the meshes of a model that was read, and loads its textures. Must run on the context
+// thread. With asyncTextures, the textures are loaded with ResourceManager::loadTextureAsync.
+gl::Model createModel(ResourceManager& res, const std::string& modelPath,
+                      const ModelData& modelData, bool asyncTextures = false);
+
+// Loads an .obj file. Faces are indexed while they are parsed, so vertices shared between
+// faces of the same material are stored once. The result is written to a binary mesh cache next
+// to the file, which is loaded instead for as long as it is newer than the file and its .mtl
+// files.
+ModelHandle loadModel(ResourceManager& res, const std::string& modelPath);
 } // namespace res
-} // namespace fc
\ No newline at end of file
+} // namespace fc
@@ -0,0 +1,411 @@
+#include "ObjParser.h"
+#include "core/Log.h"
+#include "core/Parallel.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace fc::res {
+
+namespace {
+
+// The indices of a face vertex, zero-based, or -1 for a missing texture coordinate or normal
+struct IndexTriple {
+    int32_t position;
+    int32_t texCoord;
+    int32_t normal;
+
+    bool operator==(const IndexTriple& other) const = default;
+};
+
+// Maps the index triples of a group to its vertices, with open addressing and linear probing
+// in a table whose size is a power of two
+class VertexIndexMap {
+private:
+    struct Slot {
+        IndexTriple key;
+        uint32_t vertex;
+    };
+
+    // Positions are never negative, so this marks an empty slot
+    static constexpr IndexTriple EMPTY{-1, -1, -1};
+
+    std::vector<Slot> m_Slots;
+    size_t m_Count = 0;
+
+public:
+    // The table starts small enough for the given number of triples to fill it at most half,
+    // up to 1024 slots, and grows from there
+    explicit VertexIndexMap(size_t maxCount)
+        : m_Slots(std::bit_ceil(std::clamp<size_t>(maxCount * 2, 16, 1024)), Slot{EMPTY, 0}) {}
+
+    // The vertex of the triple. If the triple is new, it is given the next vertex, and
+    // `inserted` is set.
+    uint32_t findOrInsert(const IndexTriple& key, bool& inserted) {
+        // Keep the table at most half full
+        if ((m_Count + 1) * 2 > m_Slots.size()) {
+            grow();
+        }
+
+        const size_t mask = m_Slots.size() - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            Slot& slot = m_Slots[i];
+            if (slot.key == key) {
+                inserted = false;
+                return slot.vertex;
+            }
+            if (slot.key == EMPTY) {
+                slot = {key, static_cast<uint32_t>(m_Count++)};
+                inserted = true;
+                return slot.vertex;
+            }
+        }
+    }
+
+private:
+    static size_t hash(const IndexTriple& key) {
+        uint64_t h = static_cast<uint32_t>(key.position) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint32_t>(key.texCoord) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint32_t>(key.normal) * 0x165667B19E3779F9ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    void grow() {
+        std::vector<Slot> old(m_Slots.size() * 2, Slot{EMPTY, 0});
+        old.swap(m_Slots);
+
+        const size_t mask = m_Slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.key == EMPTY)
+                continue;
+            size_t i = hash(slot.key) & mask;
+            while (!(m_Slots[i].key == EMPTY)) {
+                i = (i + 1) & mask;
+            }
+            m_Slots[i] = slot;
+        }
+    }
+};
+} // namespace
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static std::string_view trimmed(std::string_view text) {
+    while (!text.empty() && isBlank(text.front()))
+        text.remove_prefix(1);
+    while (!text.empty() && isBlank(text.back()))
+        text.remove_suffix(1);
+    return text;
+}
+
+// Removes and returns the first whitespace separated token of the line
+static std::string_view nextToken(std::string_view& line) {
+    size_t start = 0;
+    while (start < line.size() && isBlank(line[start]))
+        start++;
+    size_t end = start;
+    while (end < line.size() && !isBlank(line[end]))
+        end++;
+    std::string_view token = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return token;
+}
+
+static float parseFloat(std::string_view token) {
+    // from_chars does not accept a leading plus sign
+    if (!token.empty() && token.front() == '+')
+        token.remove_prefix(1);
+    float value = 0.0f;
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size())
+        throw std::invalid_argument("Invalid number in .obj file: \"" + std::string(token) + "\"");
+    return value;
+}
+
+static int64_t parseIndex(std::string_view token) {
+    int64_t value = 0;
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc() || value == 0)
+        throw std::invalid_argument("Invalid index in .obj face: \"" + std::string(token) + "\"");
+    return value;
+}
+
+// Resolves a one-based index, or a negative index counting back from the last element, to a
+// zero-based index
+static int32_t resolveIndex(int64_t index, size_t count) {
+    const int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(count) + index;
+    if (resolved < 0 || resolved >= static_cast<int64_t>(count))
+        throw std::invalid_argument("Index out of range in .obj face");
+    return static_cast<int32_t>(resolved);
+}
+
+namespace {
+
+// The faces between two usemtl lines of a chunk, as the index triples of their triangle corners
+struct FaceRun {
+    // Whether the run starts at a usemtl line, and the material it names. A run that does not
+    // continues the material of the faces before it, which may be in an earlier chunk.
+    bool usemtl = false;
+    std::string_view material;
+    std::vector<IndexTriple> corners;
+};
+
+// A part of the text that ends at the end of a line, parsed on its own
+struct Chunk {
+    std::string_view text;
+    // The line number of the first line of the chunk, and the number of lines it ends
+    size_t firstLine = 1;
+    size_t lineCount = 0;
+
+    // The vertex attributes the chunk defines, and the number defined in the chunks before it
+    size_t positionCount = 0;
+    size_t normalCount = 0;
+    size_t texCoordCount = 0;
+    size_t positionOffset = 0;
+    size_t normalOffset = 0;
+    size_t texCoordOffset = 0;
+
+    std::vector<FaceRun> runs{1};
+    std::vector<std::string_view> materialLibraries;
+    std::vector<std::string_view> ignored;
+};
+
+// The runs of faces that make up a group, in the order of the file
+struct GroupRuns {
+    std::vector<const std::vector<IndexTriple>*> runs;
+    size_t cornerCount = 0;
+};
+} // namespace
+
+// Below this size, a file is parsed on a single thread
+static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+// Calls function(keyword, line) for every line that is not blank, without its comment. The line
+// is what follows the keyword. A std::invalid_argument thrown by the function is thrown again
+// with the number of the line, counting from firstLine.
+template <typename F>
+static void forEachLine(std::string_view text, size_t firstLine, F&& function) {
+    for (size_t lineNumber = firstLine; !text.empty(); lineNumber++) {
+        const size_t lineEnd = text.find('\n');
+        std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        const size_t commentStart = line.find('#');
+        if (commentStart != std::string_view::npos)
+            line = line.substr(0, commentStart);
+
+        const std::string_view keyword = nextToken(line);
+        if (keyword.empty())
+            continue;
+
+        try {
+            function(keyword, line);
+        } catch (const std::invalid_argument& error) {
+            throw std::invalid_argument(std::string(error.what()) + " on line "
+                                        + std::to_string(lineNumber));
+        }
+    }
+}
+
+// Splits the text into about `count` chunks that end at the end of a line
+static std::vector<Chunk> splitChunks(std::string_view text, size_t count) {
+    std::vector<Chunk> chunks;
+    const size_t targetSize = text.size() / count + 1;
+    while (!text.empty()) {
+        const size_t lineEnd = text.find('\n', std::min(targetSize, text.size() - 1));
+        const size_t size = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+        chunks.emplace_back().text = text.substr(0, size);
+        text.remove_prefix(size);
+    }
+    return chunks;
+}
+
+static void countAttributes(Chunk& chunk) {
+    chunk.lineCount = std::count(chunk.text.begin(), chunk.text.end(), '\n');
+    forEachLine(chunk.text, chunk.firstLine, [&](std::string_view keyword, std::string_view) {
+        if (keyword == "v") {
+            chunk.positionCount++;
+        } else if (keyword == "vn") {
+            chunk.normalCount++;
+        } else if (keyword == "vt") {
+            chunk.texCoordCount++;
+        }
+    });
+}
+
+// Reads the vertex attributes of the chunk into their place in the arrays of the whole file,
+// and the faces into index triples. Face indices are resolved against the attributes defined
+// before them in the file, so the offsets and the first line of the chunk must be set.
+static void parseChunk(Chunk& chunk, std::vector<glm::vec3>& positions,
+                       std::vector<glm::vec3>& normals, std::vector<glm::vec2>& texCoords) {
+    size_t positionCount = chunk.positionOffset;
+    size_t normalCount = chunk.normalOffset;
+    size_t texCoordCount = chunk.texCoordOffset;
+
+    // The corners of the face being read
+    std::vector<IndexTriple> points;
+
+    forEachLine(chunk.text, chunk.firstLine, [&](std::string_view keyword, std::string_view line) {
+        if (keyword == "v") {
+            const float x = parseFloat(nextToken(line));
+            const float y = parseFloat(nextToken(line));
+            const float z = parseFloat(nextToken(line));
+            positions[positionCount++] = {x, y, z};
+        } else if (keyword == "vn") {
+            const float x = parseFloat(nextToken(line));
+            const float y = parseFloat(nextToken(line));
+            const float z = parseFloat(nextToken(line));
+            normals[normalCount++] = {x, y, z};
+        } else if (keyword == "vt") {
+            const float u = parseFloat(nextToken(line));
+            const float v = parseFloat(nextToken(line));
+            texCoords[texCoordCount++] = {u, v};
+        } else if (keyword == "f") {
+            points.clear();
+            for (std::string_view token = nextToken(line); !token.empty();
+                 token = nextToken(line)) {
+                // v, v/vt, v//vn or v/vt/vn
+                const size_t slash1 = token.find('/');
+                const size_t slash2 = slash1 == std::string_view::npos
+                                          ? std::string_view::npos
+                                          : token.find('/', slash1 + 1);
+
+                IndexTriple key{resolveIndex(parseIndex(token.substr(0, slash1)), positionCount),
+                                -1, -1};
+                if (slash1 != std::string_view::npos) {
+                    const std::string_view tex = token.substr(slash1 + 1, slash2 - slash1 - 1);
+                    if (!tex.empty())
+                        key.texCoord = resolveIndex(parseIndex(tex), texCoordCount);
+                }
+                if (slash2 != std::string_view::npos) {
+                    key.normal = resolveIndex(parseIndex(token.substr(slash2 + 1)), normalCount);
+                }
+                points.push_back(key);
+            }
+
+            std::vector<IndexTriple>& corners = chunk.runs.back().corners;
+            for (size_t i = 1; i + 1 < points.size(); i++) {
+                corners.push_back(points[0]);
+                corners.push_back(points[i]);
+                corners.push_back(points[i + 1]);
+            }
+        } else if (keyword == "usemtl") {
+            FaceRun& run = chunk.runs.emplace_back();
+            run.usemtl = true;
+            run.material = nextToken(line);
+        } else if (keyword == "mtllib") {
+            // The file name may contain spaces
+            chunk.materialLibraries.push_back(trimmed(line));
+        } else if (keyword == "o" || keyword == "g" || keyword == "s") {
+            // Objects, groups and smoothing groups are not used
+        } else if (std::find(chunk.ignored.begin(), chunk.ignored.end(), keyword)
+                   == chunk.ignored.end()) {
+            chunk.ignored.push_back(keyword);
+        }
+    });
+}
+
+// Gives every distinct index triple of the group one vertex, in the order they first appear
+static void buildGroup(ObjGroup& group, const GroupRuns& runs,
+                       const std::vector<glm::vec3>& positions,
+                       const std::vector<glm::vec3>& normals,
+                       const std::vector<glm::vec2>& texCoords) {
+    // Every group gets a table of its own size, so small groups do not fill a large table
+    VertexIndexMap vertexIndices(runs.cornerCount);
+    group.indices.reserve(runs.cornerCount);
+
+    for (const std::vector<IndexTriple>* corners : runs.runs) {
+        for (const IndexTriple& key : *corners) {
+            bool inserted = false;
+            const uint32_t index = vertexIndices.findOrInsert(key, inserted);
+            if (inserted) {
+                gl::Vertex3D vertex;
+                vertex.position = positions[key.position];
+                vertex.texCoord = key.texCoord < 0 ? glm::vec2(0) : texCoords[key.texCoord];
+                vertex.normal = key.normal < 0 ? glm::vec3(0) : normals[key.normal];
+                vertex.tangent = glm::vec3(0);
+                group.vertices.push_back(vertex);
+            }
+            group.indices.push_back(index);
+        }
+    }
+}
+
+ObjData parseObj(std::string_view text) {
+    // Count the vertex attributes of every chunk, so that each chunk knows where its own go
+    const size_t chunkCount
+        = std::min(parallel::workerCount() * 4, text.size() / MIN_CHUNK_SIZE + 1);
+    std::vector<Chunk> chunks = splitChunks(text, chunkCount);
+    parallel::forEach(chunks.size(), [&](size_t i) { countAttributes(chunks[i]); });
+
+    size_t positionCount = 0;
+    size_t normalCount = 0;
+    size_t texCoordCount = 0;
+    size_t lineCount = 0;
+    for (Chunk& chunk : chunks) {
+        chunk.firstLine = lineCount + 1;
+        lineCount += chunk.lineCount;
+        chunk.positionOffset = positionCount;
+        chunk.normalOffset = normalCount;
+        chunk.texCoordOffset = texCoordCount;
+        positionCount += chunk.positionCount;
+        normalCount += chunk.normalCount;
+        texCoordCount += chunk.texCoordCount;
+    }
+
+    std::vector<glm::vec3> positions(positionCount);
+    std::vector<glm::vec3> normals(normalCount);
+    std::vector<glm::vec2> texCoords(texCoordCount);
+    parallel::forEach(chunks.size(),
+                      [&](size_t i) { parseChunk(chunks[i], positions, normals, texCoords); });
+
+    // Join the runs of faces into groups, in the order of the file
+    ObjData data;
+    data.groups.emplace_back();
+    std::vector<GroupRuns> groupRuns(1);
+    // Unknown keywords are reported once each
+    std::unordered_set<std::string_view> ignored;
+
+    for (const Chunk& chunk : chunks) {
+        for (const FaceRun& run : chunk.runs) {
+            ObjGroup& current = data.groups.back();
+            if (run.usemtl && run.material != current.material) {
+                if (groupRuns.back().cornerCount == 0) {
+                    current.material = run.material;
+                } else {
+                    data.groups.push_back({std::string(run.material), {}, {}});
+                    groupRuns.emplace_back();
+                }
+            }
+            if (!run.corners.empty()) {
+                groupRuns.back().runs.push_back(&run.corners);
+                groupRuns.back().cornerCount += run.corners.size();
+            }
+        }
+
+        data.materialLibraries.insert(data.materialLibraries.end(),
+                                      chunk.materialLibraries.begin(),
+                                      chunk.materialLibraries.end());
+        for (std::string_view keyword : chunk.ignored) {
+            if (ignored.insert(keyword).second)
+                logLine("\tLines ignored: \"", keyword, "\"");
+        }
+    }
+
+    if (data.groups.size() > 1 && groupRuns.back().cornerCount == 0) {
+        data.groups.pop_back();
+        groupRuns.pop_back();
+    }
+
+    // The vertices of a group are its own, so the groups are indexed independently
+    parallel::forEach(data.groups.size(), [&](size_t i) {
+        buildGroup(data.groups[i], groupRuns[i], positions, normals, texCoords);
+    });
+    return data;
+}
+
+} // namespace fc::res
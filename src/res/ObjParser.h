@@ -0,0 +1,32 @@
+#pragma once
+#include "gl/Vertex3D.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fc::res {
+
+// The faces of an .obj file that use the same material, as indexed triangles. Every distinct
+// combination of position, texture coordinate and normal indices in the faces becomes one
+// vertex, so no two vertices are the same.
+struct ObjGroup {
+    // Empty if the faces came before any usemtl
+    std::string material;
+    std::vector<gl::Vertex3D> vertices;
+    std::vector<uint32_t> indices;
+};
+
+struct ObjData {
+    // The files named by mtllib, relative to the .obj file
+    std::vector<std::string> materialLibraries;
+    std::vector<ObjGroup> groups;
+};
+
+// Parses the text of an .obj file. Lines are tokenized in place, without copying them, and
+// numbers are read with std::from_chars. Large files are split into chunks of whole lines that
+// are parsed on several threads, and the groups are then indexed on several threads. Throws
+// std::invalid_argument, naming the line, on malformed numbers and faces.
+ObjData parseObj(std::string_view text);
+
+} // namespace fc::res
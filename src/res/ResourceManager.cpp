@@ -1,9 +1,13 @@
 #include "ResourceManager.h"
 #include "MeshLoader.h"
 #include "gl/Texture2D.h"
+#include "core/Log.h"
+#include "core/Parallel.h"
+#include "res/Image.h"
+#include <algorithm>
 
-inline size_t hashMesh(const std::vector<fc::gl::Vertex3D>& vertices,
-                       const std::vector<GLuint>& indices) {
+inline size_t hashMesh(std::span<const fc::gl::Vertex3D> vertices,
+                       std::span<const GLuint> indices) {
     size_t seed = vertices.size() ^ (indices.size() << 1);
 
     for (const auto& v : vertices) {
@@ -33,6 +37,28 @@ fc::res::TextureHandle fc::res::ResourceManager::loadTexture(const std::string&
     return texture;
 }
 
+fc::res::AtlasRegionHandle fc::res::ResourceManager::loadAtlasTexture(const std::string& path,
+                                                                     bool blurred) {
+    const TextureKey key{path, blurred};
+
+    auto it = atlasRegions.find(key);
+    if (it != atlasRegions.end()) {
+        return it->second;
+    }
+
+    const auto region = std::make_shared<const AtlasRegion>(atlas(blurred).add(path));
+    atlasRegions.emplace(key, region);
+    return region;
+}
+
+fc::res::TextureAtlas& fc::res::ResourceManager::atlas(bool blurred) {
+    std::unique_ptr<TextureAtlas>& atlas = blurred ? blurredAtlas : sharpAtlas;
+    if (atlas == nullptr) {
+        atlas = std::make_unique<TextureAtlas>(blurred);
+    }
+    return *atlas;
+}
+
 fc::res::ShaderHandle fc::res::ResourceManager::loadShader(const std::string& vertexPath,
                                                            const std::string& fragmentPath) {
     const ShaderKey key{ShaderSourceType::FromFile, vertexPath, fragmentPath};
@@ -70,8 +96,8 @@ fc::res::ResourceManager::loadShaderSource(const std::string& vertexSource,
 }
 
 fc::res::MeshHandle
-fc::res::ResourceManager::loadMesh(const std::vector<fc::gl::Vertex3D>& vertices,
-                                   const std::vector<GLuint>& indices) {
+fc::res::ResourceManager::loadMesh(std::span<const fc::gl::Vertex3D> vertices,
+                                   std::span<const GLuint> indices) {
     const MeshKey key{hashMesh(vertices, indices)};
 
     auto it = meshes.find(key);
@@ -114,3 +140,126 @@ fc::res::ModelHandle fc::res::ResourceManager::loadModel(gl::Model&& model,
     models[key] = handle;
     return handle;
 }
+
+// The status of a load that may still be running
+template <typename Key>
+static std::shared_ptr<const fc::res::LoadStatus>
+loadStatus(const std::unordered_map<Key, std::shared_ptr<fc::res::LoadStatus>>& pending,
+           const Key& key) {
+    auto it = pending.find(key);
+    if (it != pending.end()) {
+        return it->second;
+    }
+    return fc::res::readyStatus();
+}
+
+// Forgets a load once it is uploaded, unless a newer load of the same key replaced it
+template <typename Key>
+static void finishLoad(std::unordered_map<Key, std::shared_ptr<fc::res::LoadStatus>>& pending,
+                       const Key& key, const std::shared_ptr<fc::res::LoadStatus>& status) {
+    auto it = pending.find(key);
+    if (it != pending.end() && it->second == status) {
+        pending.erase(it);
+    }
+}
+
+fc::res::Async<fc::gl::Texture2D>
+fc::res::ResourceManager::loadTextureAsync(const std::string& path, bool blurred) {
+    const TextureKey key{path, blurred};
+
+    auto it = textures.find(key);
+    if (it != textures.end()) {
+        if (auto existing = it->second.lock()) {
+            return {existing, loadStatus(pendingTextures, key)};
+        }
+    }
+
+    const auto texture = std::make_shared<gl::Texture2D>(
+        Image::filled(1, 1, glm::u8vec4(255, 255, 255, 255)), blurred);
+    textures[key] = texture;
+    const auto status = std::make_shared<LoadStatus>();
+    pendingTextures[key] = status;
+
+    // The worker only decodes. The texture is not touched until the upload, on this thread.
+    workers().submit([this, uploads = uploads, key, status, target = std::weak_ptr(texture)]() {
+        const auto image = std::make_shared<const Image>(key.path);
+
+        uploads->push([this, key, status, target, image]() {
+            finishLoad(pendingTextures, key, status);
+            if (!image->valid()) {
+                logLine("Error loading texture: ", image->error());
+                status->state = LoadState::Failed;
+                status->error = image->error();
+                return;
+            }
+            if (auto texture = target.lock()) {
+                texture->setImage(*image);
+            }
+            status->state = LoadState::Ready;
+        });
+    });
+
+    return {texture, status};
+}
+
+fc::res::Async<fc::gl::Model> fc::res::ResourceManager::loadModelAsync(const std::string& path) {
+    const ModelKey key{path};
+
+    auto it = models.find(key);
+    if (it != models.end()) {
+        if (auto existing = it->second.lock()) {
+            return {existing, loadStatus(pendingModels, key)};
+        }
+    }
+
+    const ModelHandle model = loadModel(gl::Model(), path);
+    const auto status = std::make_shared<LoadStatus>();
+    pendingModels[key] = status;
+
+    workers().submit([this, uploads = uploads, key, status, target = std::weak_ptr(model)]() {
+        std::shared_ptr<const ModelData> data;
+        std::string error;
+        try {
+            data = readModel(key.path);
+        } catch (const std::exception& exception) {
+            error = exception.what();
+        }
+
+        uploads->push([this, key, status, target, data, error]() {
+            finishLoad(pendingModels, key, status);
+            if (!data) {
+                logLine("Error loading model: ", error);
+                status->state = LoadState::Failed;
+                status->error = error;
+                return;
+            }
+
+            // Only the submeshes and the shader are filled in, so a transform or instances set
+            // on the placeholder are kept
+            if (auto model = target.lock()) {
+                gl::Model loaded = createModel(*this, key.path, *data, true);
+                model->subMeshes = std::move(loaded.subMeshes);
+                model->shader = std::move(loaded.shader);
+            }
+            status->state = LoadState::Ready;
+        });
+    });
+
+    return {model, status};
+}
+
+size_t fc::res::ResourceManager::processUploads(time::Duration budget) {
+    return uploads->process(budget);
+}
+
+size_t fc::res::ResourceManager::pendingUploads() const {
+    return uploads->size();
+}
+
+fc::ThreadPool& fc::res::ResourceManager::workers() {
+    if (workerPool == nullptr) {
+        // The context thread keeps one core to itself
+        workerPool = std::make_unique<ThreadPool>(std::max<size_t>(1, parallel::workerCount() - 1));
+    }
+    return *workerPool;
+}
@@ -3,10 +3,14 @@
 #include "gl/OpenGL.h"
 #include "gl/Vertex3D.h"
 #include "glm/glm.hpp"
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "Async.h"
+#include "TextureAtlas.h"
+#include "UploadQueue.h"
 #include "types.h"
 
 #include "gl/Mesh.h"
@@ -14,6 +18,9 @@
 #include "gl/Shader.h"
 #include "gl/Texture.h"
 
+#include "core/ThreadPool.h"
+#include "core/Time.h"
+
 #include <memory>
 
 namespace fc {
@@ -128,24 +135,64 @@ public:
 
     // Load a texture from file
     TextureHandle loadTexture(const std::string& path, bool blurred = false);
+    // Load a texture from file into the shared atlas, so that it can be batched with other
+    // atlas textures. The region stays in the atlas for as long as the ResourceManager lives.
+    AtlasRegionHandle loadAtlasTexture(const std::string& path, bool blurred = false);
+    // The atlas used by loadAtlasTexture
+    TextureAtlas& atlas(bool blurred = false);
     // Load a shader from file
     ShaderHandle loadShader(const std::string& vertexPath, const std::string& fragmentPath);
     // Load a shader from source strings
     ShaderHandle loadShaderSource(const std::string& vertexSource,
                                   const std::string& fragmentSource);
     // Load a mesh from vertices and indices
-    MeshHandle loadMesh(const std::vector<gl::Vertex3D>& vertices,
-                        const std::vector<GLuint>& indices);
+    MeshHandle loadMesh(std::span<const gl::Vertex3D> vertices, std::span<const GLuint> indices);
     // Load a model from file
     ModelHandle loadModel(const std::string& path);
 
     // Load a model from memory. Note! this moves the model supplied
     ModelHandle loadModel(gl::Model&& model, const std::string& path);
 
+    // Load a texture in the background. It is returned at once as a 1x1 white placeholder, and
+    // the image is decoded on a worker thread and uploaded into the same texture by
+    // processUploads, which marks nothing dirty. loadTexture returns the placeholder while the
+    // load is running. Only the texture itself is filled in, so its pixels must not be copied
+    // into a texture array or an atlas before the handle is ready. loadAtlasTexture decodes the
+    // file itself instead.
+    Async<gl::Texture2D> loadTextureAsync(const std::string& path, bool blurred = false);
+    // Load a model in the background. It is returned at once without submeshes, which draws
+    // nothing, and the file is read on a worker thread. processUploads then creates the
+    // submeshes of the same model, and loads its textures in the background too. Like with
+    // textures, nothing is marked dirty, and loadModel returns the placeholder while the load
+    // is running.
+    Async<gl::Model> loadModelAsync(const std::string& path);
+
+    // Runs the uploads of finished background loads, oldest first, until the budget is used up.
+    // Must be called on the context thread, once per frame. Returns the number of uploads that
+    // ran. Uploads fill in resources without marking any element dirty, so when any ran, the
+    // Display must be marked dirty for them to show.
+    size_t processUploads(time::Duration budget);
+    // The number of uploads waiting for processUploads
+    size_t pendingUploads() const;
+
 private:
+    ThreadPool& workers();
+
     std::unordered_map<TextureKey, std::weak_ptr<gl::Texture2D>> textures;
+    std::unordered_map<TextureKey, AtlasRegionHandle> atlasRegions;
+    std::unique_ptr<TextureAtlas> sharpAtlas;
+    std::unique_ptr<TextureAtlas> blurredAtlas;
     std::unordered_map<ShaderKey, std::weak_ptr<gl::Shader>> shaders;
     std::unordered_map<MeshKey, std::weak_ptr<gl::Mesh>> meshes;
     std::unordered_map<ModelKey, std::weak_ptr<gl::Model>> models;
+
+    // The background loads that are not uploaded yet
+    std::unordered_map<TextureKey, std::shared_ptr<LoadStatus>> pendingTextures;
+    std::unordered_map<ModelKey, std::shared_ptr<LoadStatus>> pendingModels;
+
+    // Shared with the jobs of the workers, which push to it
+    std::shared_ptr<UploadQueue> uploads = std::make_shared<UploadQueue>();
+    // Destroyed first, so that no job is running when the rest is destroyed
+    std::unique_ptr<ThreadPool> workerPool;
 };
 } // namespace fc::res
@@ -0,0 +1,148 @@
+#include "TextureAtlas.h"
+#include "Image.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+fc::gl::SSBOLayout fc::res::TextureAtlas::regionLayout() {
+    gl::SSBOLayout layout;
+    layout.addVariableSizedComponent<GPURegion>(0);
+    return layout;
+}
+
+fc::res::TextureAtlas::TextureAtlas(bool blurred, int pageSize, int padding)
+    : m_PageSize(pageSize),
+      m_Padding(padding),
+      m_Texture(pageSize, pageSize, blurred),
+      m_RegionBuffer(regionLayout()) {
+    static_assert(sizeof(GPURegion) == 32, "GPURegion must match the std430 layout");
+}
+
+fc::res::AtlasRegion fc::res::TextureAtlas::add(int width, int height, const void* data) {
+    const int paddedWidth = width + 2 * m_Padding;
+    const int paddedHeight = height + 2 * m_Padding;
+
+    if (width <= 0 || height <= 0 || paddedWidth > m_PageSize || paddedHeight > m_PageSize) {
+        throw std::invalid_argument("Can not add a " + std::to_string(width) + "x"
+                                    + std::to_string(height) + " image to an atlas with "
+                                    + std::to_string(m_PageSize) + "x"
+                                    + std::to_string(m_PageSize) + " pages");
+    }
+
+    // Use the first page with room, adding a page if none has
+    uint32_t page = 0;
+    glm::ivec2 position;
+    for (; page < m_Skylines.size(); page++) {
+        if (findPosition(m_Skylines[page], paddedWidth, paddedHeight, position))
+            break;
+    }
+
+    if (page == m_Skylines.size()) {
+        m_Texture.addEmptyLayer();
+        m_Skylines.push_back({{0, 0, m_PageSize}});
+        position = {0, 0};
+    }
+
+    placeRectangle(m_Skylines[page], position, paddedWidth, paddedHeight);
+
+    const glm::ivec2 imagePosition = position + m_Padding;
+    m_Texture.setSubImage(page, imagePosition.x, imagePosition.y, width, height, data);
+
+    AtlasRegion region;
+    region.atlas = this;
+    region.index = static_cast<uint32_t>(m_Regions.size());
+    region.page = page;
+    region.uvMin = glm::vec2(imagePosition) / static_cast<float>(m_PageSize);
+    region.uvMax = glm::vec2(imagePosition + glm::ivec2(width, height))
+                   / static_cast<float>(m_PageSize);
+    region.size = {width, height};
+
+    m_Regions.push_back({glm::vec4(region.uvMin, region.uvMax), page, {0, 0, 0}});
+    m_RegionsDirty = true;
+
+    return region;
+}
+
+fc::res::AtlasRegion fc::res::TextureAtlas::add(const std::string& path) {
+    // Flipped like gl::Texture2D
+    const Image image(path);
+    if (!image.valid()) {
+        throw std::invalid_argument("Error loading texture: " + image.error());
+    }
+    return add(image.width(), image.height(), image.pixels());
+}
+
+void fc::res::TextureAtlas::bindRegions(GLuint index) {
+    if (m_RegionsDirty) {
+        m_RegionBuffer.resizeLast(static_cast<GLuint>(m_Regions.size()));
+        m_RegionBuffer.setData(m_Regions.data(), 0);
+        m_RegionsDirty = false;
+    }
+    m_RegionBuffer.bindIndex(index);
+}
+
+bool fc::res::TextureAtlas::findPosition(const std::vector<SkylineSegment>& skyline, int width,
+                                         int height, glm::ivec2& position) const {
+    int bestY = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    bool found = false;
+
+    for (size_t i = 0; i < skyline.size(); i++) {
+        const int x = skyline[i].x;
+        if (x + width > m_PageSize)
+            break;
+
+        // The rectangle rests on the highest segment it spans
+        int y = 0;
+        int remaining = width;
+        for (size_t j = i; remaining > 0; j++) {
+            y = std::max(y, skyline[j].y);
+            remaining -= skyline[j].width;
+        }
+
+        if (y + height > m_PageSize)
+            continue;
+
+        // Prefer the lowest position, then the narrowest segment to waste less space
+        if (y < bestY || (y == bestY && skyline[i].width < bestWidth)) {
+            bestY = y;
+            bestWidth = skyline[i].width;
+            position = {x, y};
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void fc::res::TextureAtlas::placeRectangle(std::vector<SkylineSegment>& skyline,
+                                           glm::ivec2 position, int width, int height) {
+    // Find the segment the rectangle starts at
+    size_t first = 0;
+    while (skyline[first].x != position.x) {
+        first++;
+    }
+
+    // Remove the segments covered by the rectangle, shortening the last one
+    const int right = position.x + width;
+    size_t last = first;
+    while (last < skyline.size() && skyline[last].x + skyline[last].width <= right) {
+        last++;
+    }
+    if (last < skyline.size() && skyline[last].x < right) {
+        skyline[last].width -= right - skyline[last].x;
+        skyline[last].x = right;
+    }
+    skyline.erase(skyline.begin() + first, skyline.begin() + last);
+    skyline.insert(skyline.begin() + first, {position.x, position.y + height, width});
+
+    // Merge neighbouring segments at the same height
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+}
\ No newline at end of file
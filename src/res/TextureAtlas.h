@@ -0,0 +1,83 @@
+#pragma once
+
+#include "gl/SSBO.h"
+#include "gl/Texture2DArray.h"
+#include "glm/glm.hpp"
+#include "types.h"
+#include <string>
+#include <vector>
+
+namespace fc::res {
+
+class TextureAtlas;
+
+// A single image packed into a TextureAtlas
+struct AtlasRegion {
+    TextureAtlas* atlas;
+    // The index of the region in the atlas, used to look the region up in shaders
+    uint32_t index;
+    // The layer of the atlas texture array the image is on
+    uint32_t page;
+    glm::vec2 uvMin;
+    glm::vec2 uvMax;
+    glm::ivec2 size;
+};
+
+// Packs many small images into a few large pages, so that they can all be drawn without
+// changing textures. The pages are the layers of a single texture array, and images are
+// placed with a skyline bottom-left packer. Space is never reclaimed.
+class TextureAtlas {
+private:
+    // The top edge of the packed images. Every segment starts at x, is width pixels wide and
+    // has everything below y taken.
+    struct SkylineSegment {
+        int x, y, width;
+    };
+
+    // The layout of a region as read by shaders (std430)
+    struct GPURegion {
+        glm::vec4 uvRect; // uvMin, uvMax
+        GLuint page;
+        GLuint padding[3];
+    };
+
+    int m_PageSize;
+    int m_Padding;
+
+    gl::Texture2DArray m_Texture;
+    std::vector<std::vector<SkylineSegment>> m_Skylines;
+
+    std::vector<GPURegion> m_Regions;
+    gl::SSBO m_RegionBuffer;
+    bool m_RegionsDirty = false;
+
+public:
+    TextureAtlas(bool blurred = false, int pageSize = 2048, int padding = 1);
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Packs an image with RGBA8 pixels into the atlas
+    AtlasRegion add(int width, int height, const void* data);
+    // Loads an image from file and packs it into the atlas
+    AtlasRegion add(const std::string& path);
+
+    inline const gl::Texture2DArray& texture() const { return m_Texture; }
+    inline uint32_t pageCount() const { return static_cast<uint32_t>(m_Skylines.size()); }
+    inline uint32_t regionCount() const { return static_cast<uint32_t>(m_Regions.size()); }
+
+    // Binds the regions as an array of {vec4 uvRect; uint page;} to the given shader storage
+    // binding, uploading them first if regions were added since the last call
+    void bindRegions(GLuint index);
+
+private:
+    static gl::SSBOLayout regionLayout();
+
+    // Finds the lowest position the rectangle fits at on the page. Returns false if it
+    // does not fit.
+    bool findPosition(const std::vector<SkylineSegment>& skyline, int width, int height,
+                      glm::ivec2& position) const;
+    void placeRectangle(std::vector<SkylineSegment>& skyline, glm::ivec2 position, int width,
+                        int height);
+};
+} // namespace fc::res
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "UploadQueue.h"
+#include <chrono>
+#include <utility>
+
+namespace fc::res {
+
+void UploadQueue::push(std::function<void()> upload) {
+    std::lock_guard lock(m_Mutex);
+    m_Uploads.push_back(std::move(upload));
+}
+
+size_t UploadQueue::process(time::Duration budget) {
+    // Finer than time::now(), since a budget is usually a few milliseconds
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget.millis());
+
+    size_t count = 0;
+    do {
+        std::function<void()> upload;
+        {
+            std::lock_guard lock(m_Mutex);
+            if (m_Uploads.empty())
+                return count;
+            upload = std::move(m_Uploads.front());
+            m_Uploads.pop_front();
+        }
+        // Run without the lock, so that the loading threads can keep pushing
+        upload();
+        count++;
+    } while (std::chrono::steady_clock::now() < end);
+
+    return count;
+}
+
+size_t UploadQueue::size() const {
+    std::lock_guard lock(m_Mutex);
+    return m_Uploads.size();
+}
+
+} // namespace fc::res
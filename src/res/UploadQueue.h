@@ -0,0 +1,29 @@
+#pragma once
+#include "core/Time.h"
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace fc::res {
+
+// Hands work that needs the OpenGL context, such as uploading a decoded image, from the loading
+// threads to the context thread. Uploads can be pushed from any thread, and are run by
+// process() on the context thread.
+class UploadQueue {
+private:
+    std::deque<std::function<void()>> m_Uploads;
+    mutable std::mutex m_Mutex;
+
+public:
+    void push(std::function<void()> upload);
+
+    // Runs uploads in the order they were pushed until the budget is used up. An upload is never
+    // split, and at least one runs per call, so the queue always makes progress. Returns the
+    // number of uploads that ran.
+    size_t process(time::Duration budget);
+
+    size_t size() const;
+};
+
+} // namespace fc::res
@@ -10,8 +10,11 @@ class Model;
 } // namespace fc::gl
 
 namespace fc::res {
+struct AtlasRegion;
+
 using TextureHandle = std::shared_ptr<fc::gl::Texture2D>;
 using ShaderHandle = std::shared_ptr<fc::gl::Shader>;
 using MeshHandle = std::shared_ptr<fc::gl::Mesh>;
 using ModelHandle = std::shared_ptr<fc::gl::Model>;
+using AtlasRegionHandle = std::shared_ptr<const fc::res::AtlasRegion>;
 } // namespace fc::res